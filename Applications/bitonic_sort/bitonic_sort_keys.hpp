@@ -0,0 +1,210 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_KEYS_HPP
+#define _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_KEYS_HPP
+
+#include <hip/hip_runtime.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/// \brief Order-preserving transform of the keys of type \p Key into unsigned integers of the same
+/// size (\p Radix), such that keys compare like their transforms. The sort compares the
+/// transforms, so that all key types are sorted by the same unsigned comparisons. \p from_radix
+/// is the inverse transform.
+template<typename Key>
+struct BitonicKeyTraits;
+
+template<>
+struct BitonicKeyTraits<std::uint32_t>
+{
+    using Radix = std::uint32_t;
+    __host__ __device__ static Radix to_radix(const std::uint32_t key)
+    {
+        return key;
+    }
+    __host__ __device__ static std::uint32_t from_radix(const Radix radix)
+    {
+        return radix;
+    }
+};
+
+template<>
+struct BitonicKeyTraits<std::uint64_t>
+{
+    using Radix = std::uint64_t;
+    __host__ __device__ static Radix to_radix(const std::uint64_t key)
+    {
+        return key;
+    }
+    __host__ __device__ static std::uint64_t from_radix(const Radix radix)
+    {
+        return radix;
+    }
+};
+
+/// Two's complement integers are ordered like unsigned integers once their sign bit is flipped.
+template<>
+struct BitonicKeyTraits<std::int32_t>
+{
+    using Radix = std::uint32_t;
+    __host__ __device__ static Radix to_radix(const std::int32_t key)
+    {
+        return static_cast<Radix>(key) ^ (Radix{1} << 31);
+    }
+    __host__ __device__ static std::int32_t from_radix(const Radix radix)
+    {
+        return static_cast<std::int32_t>(radix ^ (Radix{1} << 31));
+    }
+};
+
+template<>
+struct BitonicKeyTraits<std::int64_t>
+{
+    using Radix = std::uint64_t;
+    __host__ __device__ static Radix to_radix(const std::int64_t key)
+    {
+        return static_cast<Radix>(key) ^ (Radix{1} << 63);
+    }
+    __host__ __device__ static std::int64_t from_radix(const Radix radix)
+    {
+        return static_cast<std::int64_t>(radix ^ (Radix{1} << 63));
+    }
+};
+
+/// \brief Transform of IEEE 754 floating-point numbers with the bit pattern \p bits: the sign bit
+/// of positive numbers is flipped, and all bits of negative numbers are inverted, so that the
+/// magnitudes of negative numbers are ordered decreasingly. This orders -0 before +0, and NaNs
+/// with the sign bit clear after +inf and those with the sign bit set before -inf.
+template<typename Radix>
+__host__ __device__ inline Radix floating_point_to_radix(const Radix bits)
+{
+    constexpr Radix sign_bit = Radix{1} << (sizeof(Radix) * 8 - 1);
+    return (bits & sign_bit) ? ~bits : bits ^ sign_bit;
+}
+
+/// \brief Inverse of \p floating_point_to_radix: returns the bit pattern of the floating-point
+/// number with the transform \p radix.
+template<typename Radix>
+__host__ __device__ inline Radix radix_to_floating_point(const Radix radix)
+{
+    constexpr Radix sign_bit = Radix{1} << (sizeof(Radix) * 8 - 1);
+    return (radix & sign_bit) ? radix ^ sign_bit : ~radix;
+}
+
+template<>
+struct BitonicKeyTraits<float>
+{
+    using Radix = std::uint32_t;
+    __host__ __device__ static Radix to_radix(const float key)
+    {
+        Radix bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return floating_point_to_radix(bits);
+    }
+    __host__ __device__ static float from_radix(const Radix radix)
+    {
+        const Radix bits = radix_to_floating_point(radix);
+        float       key;
+        std::memcpy(&key, &bits, sizeof(key));
+        return key;
+    }
+};
+
+template<>
+struct BitonicKeyTraits<double>
+{
+    using Radix = std::uint64_t;
+    __host__ __device__ static Radix to_radix(const double key)
+    {
+        Radix bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return floating_point_to_radix(bits);
+    }
+    __host__ __device__ static double from_radix(const Radix radix)
+    {
+        const Radix bits = radix_to_floating_point(radix);
+        double      key;
+        std::memcpy(&key, &bits, sizeof(key));
+        return key;
+    }
+};
+
+/// \brief Returns whether the keys \p left and \p right, in this order, must be swapped to order
+/// them increasingly if \p sort_increasing is true, and decreasingly otherwise. Equal keys are
+/// never swapped.
+template<typename Key>
+__host__ __device__ inline bool
+    bitonic_keys_out_of_order(const Key& left, const Key& right, const bool sort_increasing)
+{
+    const auto left_radix  = BitonicKeyTraits<Key>::to_radix(left);
+    const auto right_radix = BitonicKeyTraits<Key>::to_radix(right);
+    return sort_increasing ? left_radix > right_radix : left_radix < right_radix;
+}
+
+/// \brief Key types of the sort.
+enum class BitonicKeyType
+{
+    u32,
+    u64,
+    i32,
+    i64,
+    f32,
+    f64
+};
+
+/// \brief Returns the name of a \p BitonicKeyType, as accepted by \p parse_bitonic_key_type.
+inline const char* bitonic_key_type_name(const BitonicKeyType type)
+{
+    switch(type)
+    {
+        case BitonicKeyType::u64: return "u64";
+        case BitonicKeyType::i32: return "i32";
+        case BitonicKeyType::i64: return "i64";
+        case BitonicKeyType::f32: return "f32";
+        case BitonicKeyType::f64: return "f64";
+        default: return "u32";
+    }
+}
+
+/// \brief Parses the name of a \p BitonicKeyType. Returns false if \p name is not valid.
+inline bool parse_bitonic_key_type(const std::string& name, BitonicKeyType& type)
+{
+    for(const BitonicKeyType candidate : {BitonicKeyType::u32,
+                                          BitonicKeyType::u64,
+                                          BitonicKeyType::i32,
+                                          BitonicKeyType::i64,
+                                          BitonicKeyType::f32,
+                                          BitonicKeyType::f64})
+    {
+        if(name == bitonic_key_type_name(candidate))
+        {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_KEYS_HPP
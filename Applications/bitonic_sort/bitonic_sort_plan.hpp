@@ -0,0 +1,298 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_PLAN_HPP
+#define _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_PLAN_HPP
+
+#include "bitonic_sort_keys.hpp"
+
+#include <hip/hip_runtime.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/// \brief Pair of elements that a thread compares in a stage of the bitonic sort. The element
+/// at \p left_id is ordered before the one at \p right_id.
+struct BitonicPair
+{
+    unsigned int left_id;
+    unsigned int right_id;
+};
+
+/// \brief Returns the pair of elements that thread \p thread_id sorts in the j-th stage within the
+/// i-th step of the bitonic sort. Shared by the kernels and the host tasks.
+///
+/// Step i merges pairs of sorted blocks of <tt>2^i</tt> elements into sorted blocks of
+/// <tt>2^(i + 1)</tt> elements. Its first stage compares the elements at mirrored positions of
+/// the merged block, the first with the last and so on, which is equivalent to comparing the
+/// first block with the reversed second block. The result consists of two bitonic halves, which
+/// the remaining stages sort by comparing elements half their width apart. Hence every pair is
+/// ordered in the same direction, unlike in the formulation that sorts every other block
+/// decreasingly, so elements beyond the end of the array can stand for virtual padding that
+/// orders after every key and never moves: pairs whose right element is beyond the end are
+/// skipped.
+__host__ __device__ inline BitonicPair get_bitonic_pair(const unsigned int thread_id,
+                                                        const unsigned int step,
+                                                        const unsigned int stage)
+{
+    // Distance between the two elements that each thread sorts, in stages other than the first.
+    const unsigned int pair_distance = 1 << (step - stage);
+
+    // Total number of elements of each subsequence processed.
+    const unsigned int sorted_block_width = 2 * pair_distance;
+
+    // Compute indexes of the elements of the array that the thread will sort.
+    const unsigned int offset  = thread_id % pair_distance;
+    const unsigned int left_id = offset + (thread_id / pair_distance) * sorted_block_width;
+    const unsigned int right_id
+        = stage == 0 ? left_id - offset + sorted_block_width - 1 - offset : left_id + pair_distance;
+
+    return {left_id, right_id};
+}
+
+/// \brief Compares the keys \p left_key and \p right_key and swaps them, and the values at
+/// \p left_value and \p right_value if \p values is true, if they are out of order (see
+/// \p bitonic_keys_out_of_order).
+template<typename Key, typename Value>
+__host__ __device__ inline void bitonic_compare_and_swap(Key&       left_key,
+                                                         Key&       right_key,
+                                                         Value&     left_value,
+                                                         Value&     right_value,
+                                                         const bool values,
+                                                         const bool sort_increasing)
+{
+    if(bitonic_keys_out_of_order(left_key, right_key, sort_increasing))
+    {
+        const Key key = left_key;
+        left_key      = right_key;
+        right_key     = key;
+        if(values)
+        {
+            const Value value = left_value;
+            left_value        = right_value;
+            right_value       = value;
+        }
+    }
+}
+
+/// \brief Advances (\p step, \p stage) to the next stage of the bitonic sort: the stages of a
+/// step are followed by the first stage of the next step.
+__host__ __device__ inline void advance_bitonic_stage(unsigned int& step, unsigned int& stage)
+{
+    if(++stage > step)
+    {
+        ++step;
+        stage = 0;
+    }
+}
+
+/// \brief Pass of the bitonic sort over the array: \p stages consecutive stages, starting at
+/// stage \p stage of step \p step.
+///
+/// A global pass executes a single stage, which compares every pair of elements where they are
+/// stored. A local pass executes all of its stages on one tile of the array at a time, which it
+/// reads once, sorts in local memory and writes back once. This is possible for the stages whose
+/// pairs of elements never cross the border of a tile.
+struct BitonicPass
+{
+    unsigned int step   = 0;
+    unsigned int stage  = 0;
+    unsigned int stages = 1;
+    bool         local  = false;
+};
+
+/// \brief Schedule of the bitonic sort of an array of \p length elements, as a sequence of passes
+/// over the array. The sort network is the one of <tt>2^steps</tt> elements, the smallest power
+/// of 2 not below \p length, whose elements from \p length on are virtual padding. The plan is
+/// built once on the host, and executed by the kernel launches as well as by the host tasks.
+struct BitonicSortPlan
+{
+    unsigned int length = 0;
+    unsigned int steps  = 0;
+
+    /// Number of elements of the tiles of the local passes, 0 if there are none.
+    unsigned int tile_size = 0;
+
+    std::vector<BitonicPass> passes;
+
+    /// \brief Number of stages of all passes.
+    std::size_t stages() const
+    {
+        return static_cast<std::size_t>(steps) * (steps + 1) / 2;
+    }
+
+    /// \brief Number of local passes.
+    std::size_t local_passes() const
+    {
+        return std::count_if(passes.begin(),
+                             passes.end(),
+                             [](const BitonicPass& pass) { return pass.local; });
+    }
+};
+
+/// \brief Builds the plan of the bitonic sort of an array of \p length elements, at most 2^31,
+/// in which the stages whose pairs of elements lie within tiles of \p tile_size elements are
+/// fused into local passes. \p tile_size must be 0, which disables fusion and yields one global
+/// pass per stage, or a power of 2. It is lowered to the padded length of the array if
+/// necessary.
+///
+/// Stage j of step i compares elements <tt>2^(i - j)</tt> apart within blocks of
+/// <tt>2^(i - j + 1)</tt> elements, so it is local if the blocks fit in a tile. That is the case
+/// for all stages of the first <tt>log_2(tile_size)</tt> steps, which form a single local pass,
+/// and for the last <tt>log_2(tile_size)</tt> stages of every later step, whose first stages are
+/// global passes. Hence, with <tt>k = steps - log_2(tile_size)</tt>, the number of passes over
+/// the array falls from <tt>steps * (steps + 1) / 2</tt> to <tt>k * (k + 1) / 2</tt> global
+/// passes and <tt>k + 1</tt> local passes.
+inline BitonicSortPlan make_bitonic_sort_plan(const unsigned int length, unsigned int tile_size)
+{
+    unsigned int steps = 0;
+    while((std::size_t{1} << steps) < length)
+    {
+        ++steps;
+    }
+    tile_size = std::min(tile_size, 1u << steps);
+
+    BitonicSortPlan plan;
+    plan.length    = length;
+    plan.steps     = steps;
+    plan.tile_size = tile_size >= 2 ? tile_size : 0;
+    for(unsigned int i = 0; i < steps; ++i)
+    {
+        for(unsigned int j = 0; j <= i; ++j)
+        {
+            const bool local = plan.tile_size != 0 && (2u << (i - j)) <= plan.tile_size;
+            if(local && !plan.passes.empty() && plan.passes.back().local)
+            {
+                ++plan.passes.back().stages;
+            }
+            else
+            {
+                plan.passes.push_back({i, j, 1, local});
+            }
+        }
+    }
+    return plan;
+}
+
+/// \brief Returns the number of work items of \p pass of \p plan: the pairs of elements of a
+/// global pass, or the tiles of a local pass that are not entirely padding.
+inline std::size_t get_bitonic_pass_size(const BitonicSortPlan& plan, const BitonicPass& pass)
+{
+    const std::size_t padded_length = std::size_t{1} << plan.steps;
+    return pass.local ? (plan.length + plan.tile_size - 1) / plan.tile_size : padded_length / 2;
+}
+
+/// \brief Executes the work items <tt>[begin, end)</tt> of \p pass of \p plan on the host, in the
+/// same way as the kernels, and returns the number of keys read from \p keys, which is also the
+/// number of keys written to it. If \p values is not null, the values are moved along with the
+/// keys. A local pass copies the elements of each of its tiles inside of the array to
+/// \p tile_keys and \p tile_values, executes its stages there and copies them back.
+template<typename Key, typename Value>
+std::size_t bitonic_sort_pass_host(Key*                   keys,
+                                   Value*                 values,
+                                   const BitonicSortPlan& plan,
+                                   const BitonicPass&     pass,
+                                   const bool             sort_increasing,
+                                   const std::size_t      begin,
+                                   const std::size_t      end,
+                                   std::vector<Key>&      tile_keys,
+                                   std::vector<Value>&    tile_values)
+{
+    // Without values, the comparators move a dummy value.
+    const bool has_values = values != nullptr;
+    Value      no_value{};
+    const auto value = [&](Value* array, const unsigned int id) -> Value&
+    { return has_values ? array[id] : no_value; };
+
+    std::size_t elements = 0;
+    if(!pass.local)
+    {
+        for(std::size_t thread_id = begin; thread_id < end; ++thread_id)
+        {
+            const BitonicPair pair
+                = get_bitonic_pair(static_cast<unsigned int>(thread_id), pass.step, pass.stage);
+            if(pair.right_id < plan.length)
+            {
+                bitonic_compare_and_swap(keys[pair.left_id],
+                                         keys[pair.right_id],
+                                         value(values, pair.left_id),
+                                         value(values, pair.right_id),
+                                         has_values,
+                                         sort_increasing);
+                elements += 2;
+            }
+        }
+        return elements;
+    }
+
+    const unsigned int tile_size  = plan.tile_size;
+    const unsigned int tile_pairs = tile_size / 2;
+    tile_keys.resize(tile_size);
+    tile_values.resize(has_values ? tile_size : 0);
+    for(std::size_t tile_id = begin; tile_id < end; ++tile_id)
+    {
+        const unsigned int tile_begin = static_cast<unsigned int>(tile_id) * tile_size;
+        const unsigned int tile_length = std::min(tile_size, plan.length - tile_begin);
+        std::copy(keys + tile_begin, keys + tile_begin + tile_length, tile_keys.begin());
+        if(has_values)
+        {
+            std::copy(values + tile_begin, values + tile_begin + tile_length, tile_values.begin());
+        }
+        unsigned int step  = pass.step;
+        unsigned int stage = pass.stage;
+        for(unsigned int s = 0; s < pass.stages; ++s)
+        {
+            // The pairs of the threads of a tile lie inside of it.
+            for(unsigned int p = 0; p < tile_pairs; ++p)
+            {
+                const BitonicPair pair
+                    = get_bitonic_pair(static_cast<unsigned int>(tile_id) * tile_pairs + p,
+                                       step,
+                                       stage);
+                const unsigned int left  = pair.left_id - tile_begin;
+                const unsigned int right = pair.right_id - tile_begin;
+                if(right < tile_length)
+                {
+                    bitonic_compare_and_swap(tile_keys[left],
+                                             tile_keys[right],
+                                             value(tile_values.data(), left),
+                                             value(tile_values.data(), right),
+                                             has_values,
+                                             sort_increasing);
+                }
+            }
+            advance_bitonic_stage(step, stage);
+        }
+        std::copy(tile_keys.begin(), tile_keys.begin() + tile_length, keys + tile_begin);
+        if(has_values)
+        {
+            std::copy(tile_values.begin(),
+                      tile_values.begin() + tile_length,
+                      values + tile_begin);
+        }
+        elements += tile_length;
+    }
+    return elements;
+}
+
+#endif // _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_PLAN_HPP
@@ -0,0 +1,230 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_SEGMENTED_HPP
+#define _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_SEGMENTED_HPP
+
+#include "bitonic_sort_keys.hpp"
+#include "bitonic_sort_simd.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/// \brief Range of the flat array of a segmented sort that is sorted independently of the rest.
+struct BitonicSegment
+{
+    unsigned int begin;
+    unsigned int length;
+};
+
+/// \brief Number of threads of the groups of the register network, each of which holds two
+/// elements of a segment in registers.
+constexpr unsigned int bitonic_register_lanes = 32;
+
+/// \brief Length of the longest segments sorted by the register network.
+constexpr unsigned int bitonic_register_segment_length = 2 * bitonic_register_lanes;
+
+/// \brief Length of the longest segments sorted in shared memory by a single block, which is
+/// also the length of the tiles in which longer segments are sorted before they are merged.
+constexpr unsigned int bitonic_local_segment_length = 4096;
+
+/// \brief Segments of a segmented sort, bucketed by the strategy that sorts them: the register
+/// network, the local bitonic sort in shared memory, or the local sort of their tiles followed by
+/// merges of the sorted tiles.
+struct BitonicSegmentBuckets
+{
+    std::vector<BitonicSegment> register_segments;
+    std::vector<BitonicSegment> local_segments;
+    std::vector<BitonicSegment> merge_segments;
+
+    /// Tiles of \p bitonic_local_segment_length elements of the merge segments.
+    std::vector<BitonicSegment> merge_tiles;
+
+    /// Length of the longest merge segment.
+    unsigned int merge_length;
+
+    /// Number of merge levels of the longest merge segment, which all merge segments execute.
+    unsigned int merge_levels;
+};
+
+/// \brief Buckets the \p segments segments of the flat array delimited by \p offsets, which has
+/// <tt>segments + 1</tt> elements: segment i is <tt>[offsets[i], offsets[i + 1])</tt>. Empty
+/// segments are left out.
+inline BitonicSegmentBuckets make_bitonic_segment_buckets(const std::vector<unsigned int>& offsets)
+{
+    BitonicSegmentBuckets buckets{};
+    for(std::size_t i = 0; i + 1 < offsets.size(); ++i)
+    {
+        const BitonicSegment segment{offsets[i], offsets[i + 1] - offsets[i]};
+        if(segment.length == 0)
+        {
+            continue;
+        }
+        if(segment.length <= bitonic_register_segment_length)
+        {
+            buckets.register_segments.push_back(segment);
+        }
+        else if(segment.length <= bitonic_local_segment_length)
+        {
+            buckets.local_segments.push_back(segment);
+        }
+        else
+        {
+            buckets.merge_segments.push_back(segment);
+            for(unsigned int tile = 0; tile < segment.length; tile += bitonic_local_segment_length)
+            {
+                buckets.merge_tiles.push_back(
+                    {segment.begin + tile,
+                     std::min(bitonic_local_segment_length, segment.length - tile)});
+            }
+            buckets.merge_length = std::max(buckets.merge_length, segment.length);
+        }
+    }
+    for(unsigned int run = bitonic_local_segment_length; run < buckets.merge_length; run *= 2)
+    {
+        ++buckets.merge_levels;
+    }
+    return buckets;
+}
+
+/// \brief Sorts the \p length words of \p words in increasing order with \p engine: in registers
+/// if they fit into a block, otherwise by sorting the blocks and merging them level by level with
+/// \p scratch.
+template<typename Word>
+void bitonic_sort_words(const BitonicSimdEngine<Word>& engine,
+                        Word*                          words,
+                        const std::size_t              length,
+                        std::vector<Word>&             scratch)
+{
+    if(length <= engine.block_size)
+    {
+        engine.sort_block(words, length);
+        return;
+    }
+    for(std::size_t block = 0; block < length; block += engine.block_size)
+    {
+        engine.sort_block(words + block, std::min(engine.block_size, length - block));
+    }
+    scratch.resize(length);
+    Word* source      = words;
+    Word* destination = scratch.data();
+    for(std::size_t run = engine.block_size; run < length; run *= 2)
+    {
+        bitonic_merge_level(engine, source, destination, length, run, 0, length);
+        std::swap(source, destination);
+    }
+    if(source != words)
+    {
+        std::copy(source, source + length, words);
+    }
+}
+
+/// \brief Sorts the segments <tt>[begin, end)</tt> of \p segments of the flat arrays \p keys and,
+/// if not null, \p values on the host with the CPU sort engine of \p level. Every segment is
+/// transformed into words, sorted and transformed back on its own. Without values, the words are
+/// the radixes of the keys. 32-bit keys are packed with their 32-bit values into 64-bit words,
+/// which orders equal keys by their values. 64-bit keys with values have no wider word to be
+/// packed into and are sorted as pairs by \p std::sort.
+template<typename Key, typename Value>
+void bitonic_sort_segments_cpu(Key*                  keys,
+                               Value*                values,
+                               const BitonicSegment* segments,
+                               const std::size_t     begin,
+                               const std::size_t     end,
+                               const bool            sort_increasing,
+                               const SimdLevel       level)
+{
+    using Traits = BitonicKeyTraits<Key>;
+    using Radix  = typename Traits::Radix;
+
+    const Radix invert = sort_increasing ? Radix{0} : ~Radix{0};
+    if(values != nullptr)
+    {
+        if constexpr(sizeof(Radix) == 4 && sizeof(Value) == 4)
+        {
+            const BitonicSimdEngine<std::uint64_t> engine
+                = get_bitonic_simd_engine<std::uint64_t>(level);
+            std::vector<std::uint64_t> words, scratch;
+            for(std::size_t s = begin; s < end; ++s)
+            {
+                const BitonicSegment segment = segments[s];
+                words.resize(segment.length);
+                for(unsigned int i = 0; i < segment.length; ++i)
+                {
+                    const Radix radix = Traits::to_radix(keys[segment.begin + i]) ^ invert;
+                    words[i]          = std::uint64_t{radix} << 32 | values[segment.begin + i];
+                }
+                bitonic_sort_words(engine, words.data(), segment.length, scratch);
+                for(unsigned int i = 0; i < segment.length; ++i)
+                {
+                    keys[segment.begin + i]
+                        = Traits::from_radix(static_cast<Radix>(words[i] >> 32) ^ invert);
+                    values[segment.begin + i] = static_cast<Value>(words[i]);
+                }
+            }
+        }
+        else
+        {
+            std::vector<std::pair<Radix, Value>> pairs;
+            for(std::size_t s = begin; s < end; ++s)
+            {
+                const BitonicSegment segment = segments[s];
+                pairs.resize(segment.length);
+                for(unsigned int i = 0; i < segment.length; ++i)
+                {
+                    pairs[i] = {Traits::to_radix(keys[segment.begin + i]) ^ invert,
+                                values[segment.begin + i]};
+                }
+                std::sort(pairs.begin(), pairs.end());
+                for(unsigned int i = 0; i < segment.length; ++i)
+                {
+                    keys[segment.begin + i]   = Traits::from_radix(pairs[i].first ^ invert);
+                    values[segment.begin + i] = pairs[i].second;
+                }
+            }
+        }
+        return;
+    }
+
+    const BitonicSimdEngine<Radix> engine = get_bitonic_simd_engine<Radix>(level);
+    std::vector<Radix>             words, scratch;
+    for(std::size_t s = begin; s < end; ++s)
+    {
+        const BitonicSegment segment = segments[s];
+        words.resize(segment.length);
+        for(unsigned int i = 0; i < segment.length; ++i)
+        {
+            words[i] = Traits::to_radix(keys[segment.begin + i]) ^ invert;
+        }
+        bitonic_sort_words(engine, words.data(), segment.length, scratch);
+        for(unsigned int i = 0; i < segment.length; ++i)
+        {
+            keys[segment.begin + i] = Traits::from_radix(words[i] ^ invert);
+        }
+    }
+}
+
+#endif // _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_SEGMENTED_HPP
@@ -0,0 +1,869 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_SIMD_HPP
+#define _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_SIMD_HPP
+
+#include "bitonic_sort_keys.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+
+    #define BITONIC_SORT_X86_SIMD
+    // GCC and Clang only allow intrinsics in functions compiled for the corresponding instruction
+    // set, while MSVC allows them anywhere.
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define BITONIC_SORT_TARGET(isa)
+    #else
+        #define BITONIC_SORT_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#endif
+
+/// \brief Returns the base 2 logarithm of the power of two \p value.
+constexpr unsigned int bitonic_log2(const unsigned int value)
+{
+    return value <= 1 ? 0 : 1 + bitonic_log2(value / 2);
+}
+
+/// \brief Permutations of the stages of the bitonic network that compare lanes of the same
+/// vector, for vectors of \p Words 32-bit words with lanes of \p LaneWords words. The stages are
+/// indexed by the base 2 logarithm of their pair distance. The permutations move words rather
+/// than lanes, so that vectors of 32 and 64-bit lanes are permuted with the same instruction.
+template<unsigned int Words, unsigned int LaneWords>
+struct BitonicLaneTables
+{
+    static constexpr unsigned int lanes  = Words / LaneWords;
+    static constexpr unsigned int stages = bitonic_log2(lanes);
+
+    /// Word of the partner lane of every word, in the stages that compare lanes at the pair
+    /// distance ([0]) and lanes mirrored around the center of blocks of twice the pair distance
+    /// ([1]). The mirrored stage of the last index reverses the vector.
+    alignas(64) std::uint32_t partners[2][stages][Words];
+
+    /// All bits set in the words of the lanes that receive the maximum of their pair.
+    alignas(64) std::uint32_t high_words[stages][Words];
+
+    /// Bit mask of the words of the lanes that receive the maximum of their pair.
+    std::uint32_t high_masks[stages];
+};
+
+/// \brief Returns the \p BitonicLaneTables for vectors of \p Words words and lanes of
+/// \p LaneWords words.
+template<unsigned int Words, unsigned int LaneWords>
+constexpr BitonicLaneTables<Words, LaneWords> make_bitonic_lane_tables()
+{
+    BitonicLaneTables<Words, LaneWords> tables{};
+    for(unsigned int stage = 0; stage < BitonicLaneTables<Words, LaneWords>::stages; ++stage)
+    {
+        const unsigned int distance = 1u << stage;
+        for(unsigned int word = 0; word < Words; ++word)
+        {
+            const unsigned int lane = word / LaneWords;
+            const unsigned int part = word % LaneWords;
+            const bool         high = (lane & distance) != 0;
+            tables.partners[0][stage][word] = (lane ^ distance) * LaneWords + part;
+            tables.partners[1][stage][word] = (lane ^ (2 * distance - 1)) * LaneWords + part;
+            tables.high_words[stage][word]  = high ? ~0u : 0u;
+            tables.high_masks[stage] |= high ? 1u << word : 0u;
+        }
+    }
+    return tables;
+}
+
+/// \brief Sorts the \p count elements of \p block, at most the block size of the engine, in
+/// increasing order.
+template<typename Radix>
+using BitonicBlockSortFunction = void (*)(Radix* block, const std::size_t count);
+
+/// \brief Merges the sorted runs \p left and \p right of \p left_count and \p right_count
+/// elements into \p output, in increasing order.
+template<typename Radix>
+using BitonicMergeFunction = void (*)(const Radix*      left,
+                                      const std::size_t left_count,
+                                      const Radix*      right,
+                                      const std::size_t right_count,
+                                      Radix*            output);
+
+/// \brief Scalar version of the block sort.
+template<typename Radix>
+void bitonic_sort_block_scalar(Radix* block, const std::size_t count)
+{
+    std::sort(block, block + count);
+}
+
+/// \brief Scalar version of the merge of two runs.
+template<typename Radix>
+void bitonic_merge_scalar(const Radix*      left,
+                          const std::size_t left_count,
+                          const Radix*      right,
+                          const std::size_t right_count,
+                          Radix*            output)
+{
+    std::merge(left, left + left_count, right, right + right_count, output);
+}
+
+/// \brief Finishes a vectorized merge: merges the \p lanes sorted elements of \p maximums, which
+/// are not less than any element merged so far, with the rests <tt>[left, left_end)</tt> and
+/// <tt>[right, right_end)</tt> of the runs, at least one of which has fewer than \p lanes
+/// elements left.
+template<typename Radix>
+void bitonic_merge_tail(const Radix*      maximums,
+                        const std::size_t lanes,
+                        const Radix*      left,
+                        const Radix*      left_end,
+                        const Radix*      right,
+                        const Radix*      right_end,
+                        Radix*            output)
+{
+    if(right_end - right >= static_cast<std::ptrdiff_t>(lanes))
+    {
+        std::swap(left, right);
+        std::swap(left_end, right_end);
+    }
+    // The short rest is merged with the maximums first, then the result with the long rest.
+    Radix        tail[2 * 16];
+    Radix* const tail_end = std::merge(maximums, maximums + lanes, right, right_end, tail);
+    std::merge(tail, tail_end, left, left_end, output);
+}
+
+#ifdef BITONIC_SORT_X86_SIMD
+/// \brief Operations on vectors of 32-bit (\p std::uint32_t) or 64-bit (\p std::uint64_t)
+/// unsigned integers of the AVX-512 instruction set.
+template<typename Radix>
+struct BitonicVectorAvx512;
+
+/// \brief Operations of \p BitonicVectorAvx512 that do not depend on the size of the lanes.
+struct BitonicVectorAvx512Base
+{
+    using Type = __m512i;
+
+    /// Number of vectors of a block sorted in registers.
+    static constexpr unsigned int registers = 16;
+
+    BITONIC_SORT_TARGET("avx512f") static Type load(const void* source)
+    {
+        return _mm512_loadu_si512(source);
+    }
+
+    BITONIC_SORT_TARGET("avx512f") static void store(void* destination, const Type vector)
+    {
+        _mm512_storeu_si512(destination, vector);
+    }
+
+    /// Moves word <tt>words[i]</tt> of \p vector to word i.
+    BITONIC_SORT_TARGET("avx512f")
+    static Type permute(const Type vector, const std::uint32_t* words)
+    {
+        return _mm512_permutexvar_epi32(_mm512_loadu_si512(words), vector);
+    }
+
+    /// Takes the words of \p high that are set in \p high_mask and the others of \p low.
+    BITONIC_SORT_TARGET("avx512f")
+    static Type blend(const Type low, const Type high, const std::uint32_t high_mask)
+    {
+        return _mm512_mask_blend_epi32(static_cast<__mmask16>(high_mask), low, high);
+    }
+};
+
+template<>
+struct BitonicVectorAvx512<std::uint32_t> : BitonicVectorAvx512Base
+{
+    static constexpr unsigned int             lanes  = 16;
+    static constexpr BitonicLaneTables<16, 1> tables = make_bitonic_lane_tables<16, 1>();
+
+    BITONIC_SORT_TARGET("avx512f")
+    static void min_max(const Type a, const Type b, Type& minimum, Type& maximum)
+    {
+        minimum = _mm512_min_epu32(a, b);
+        maximum = _mm512_max_epu32(a, b);
+    }
+};
+
+template<>
+struct BitonicVectorAvx512<std::uint64_t> : BitonicVectorAvx512Base
+{
+    static constexpr unsigned int             lanes  = 8;
+    static constexpr BitonicLaneTables<16, 2> tables = make_bitonic_lane_tables<16, 2>();
+
+    BITONIC_SORT_TARGET("avx512f")
+    static void min_max(const Type a, const Type b, Type& minimum, Type& maximum)
+    {
+        minimum = _mm512_min_epu64(a, b);
+        maximum = _mm512_max_epu64(a, b);
+    }
+};
+
+/// \brief Executes the stage of the bitonic network with pair distance <tt>2^Stage</tt>, which
+/// compares mirrored lanes if \p Mirrored is true, on the lanes of \p vector.
+template<typename Vector, bool Mirrored, unsigned int Stage>
+BITONIC_SORT_TARGET("avx512f")
+inline typename Vector::Type bitonic_exchange_avx512(const typename Vector::Type vector)
+{
+    typename Vector::Type minimum, maximum;
+    Vector::min_max(vector,
+                    Vector::permute(vector, Vector::tables.partners[Mirrored][Stage]),
+                    minimum,
+                    maximum);
+    return Vector::blend(minimum, maximum, Vector::tables.high_masks[Stage]);
+}
+
+/// \brief Executes the stages of the step of the bitonic network that sorts blocks of \p Width
+/// elements, from the one with pair distance \p Distance on, on the elements of the vectors
+/// \p vectors, in which element i is lane <tt>i % lanes</tt> of vector <tt>i / lanes</tt>.
+template<typename Vector, unsigned int Width, unsigned int Distance>
+BITONIC_SORT_TARGET("avx512f")
+inline void bitonic_stages_avx512(typename Vector::Type (&vectors)[Vector::registers])
+{
+    using Type                      = typename Vector::Type;
+    constexpr unsigned int lanes    = Vector::lanes;
+    constexpr bool         mirrored = Distance == Width / 2;
+    if constexpr(Distance >= lanes)
+    {
+        // The pairs are made of the same lanes of two vectors, or of mirrored lanes of two
+        // vectors mirrored in the block.
+        constexpr unsigned int vector_distance = Distance / lanes;
+        constexpr unsigned int block_vectors   = Width / lanes;
+        for(unsigned int v = 0; v < Vector::registers; ++v)
+        {
+            if((v & vector_distance) != 0)
+            {
+                continue;
+            }
+            const unsigned int partner = mirrored ? v ^ (block_vectors - 1) : v + vector_distance;
+            const Type         right
+                = mirrored ? Vector::permute(vectors[partner],
+                                             Vector::tables.partners[1][Vector::tables.stages - 1])
+                           : vectors[partner];
+            Type maximum;
+            Vector::min_max(vectors[v], right, vectors[v], maximum);
+            vectors[partner]
+                = mirrored ? Vector::permute(maximum,
+                                             Vector::tables.partners[1][Vector::tables.stages - 1])
+                           : maximum;
+        }
+    }
+    else
+    {
+        for(unsigned int v = 0; v < Vector::registers; ++v)
+        {
+            vectors[v] = bitonic_exchange_avx512<Vector, mirrored, bitonic_log2(Distance)>(
+                vectors[v]);
+        }
+    }
+    if constexpr(Distance > 1)
+    {
+        bitonic_stages_avx512<Vector, Width, Distance / 2>(vectors);
+    }
+}
+
+/// \brief Sorts the elements of \p vectors with the bitonic network, from the step that sorts
+/// blocks of \p Width elements on.
+template<typename Vector, unsigned int Width = 2>
+BITONIC_SORT_TARGET("avx512f")
+inline void bitonic_sort_vectors_avx512(typename Vector::Type (&vectors)[Vector::registers])
+{
+    bitonic_stages_avx512<Vector, Width, Width / 2>(vectors);
+    if constexpr(Width < Vector::registers * Vector::lanes)
+    {
+        bitonic_sort_vectors_avx512<Vector, Width * 2>(vectors);
+    }
+}
+
+/// \brief Executes the stages with pair distances from <tt>2^Stage</tt> down to 1 on the lanes of
+/// \p low and \p high, interleaved.
+template<typename Vector, unsigned int Stage>
+BITONIC_SORT_TARGET("avx512f")
+inline void bitonic_clean_avx512(typename Vector::Type& low, typename Vector::Type& high)
+{
+    low  = bitonic_exchange_avx512<Vector, false, Stage>(low);
+    high = bitonic_exchange_avx512<Vector, false, Stage>(high);
+    if constexpr(Stage > 0)
+    {
+        bitonic_clean_avx512<Vector, Stage - 1>(low, high);
+    }
+}
+
+/// \brief Merges the sorted vectors \p low and \p high, such that \p low holds the smaller half
+/// of their elements and \p high the larger one, both sorted. After the mirrored stage, both
+/// halves are bitonic sequences, which the remaining stages sort without reversing the maximums
+/// back into place.
+template<typename Vector>
+BITONIC_SORT_TARGET("avx512f")
+inline void bitonic_merge_vectors_avx512(typename Vector::Type& low, typename Vector::Type& high)
+{
+    Vector::min_max(low,
+                    Vector::permute(high, Vector::tables.partners[1][Vector::tables.stages - 1]),
+                    low,
+                    high);
+    bitonic_clean_avx512<Vector, Vector::tables.stages - 1>(low, high);
+}
+
+/// \brief AVX-512 version of \p bitonic_sort_block_scalar. The block is loaded into 16 vectors
+/// and sorted there with the bitonic network. A partial block is padded with the largest value.
+template<typename Radix>
+BITONIC_SORT_TARGET("avx512f")
+void bitonic_sort_block_avx512(Radix* block, const std::size_t count)
+{
+    using Vector                     = BitonicVectorAvx512<Radix>;
+    constexpr std::size_t block_size = Vector::registers * Vector::lanes;
+
+    Radix  padded[block_size];
+    Radix* source = block;
+    if(count < block_size)
+    {
+        std::copy(block, block + count, padded);
+        std::fill(padded + count, padded + block_size, std::numeric_limits<Radix>::max());
+        source = padded;
+    }
+
+    typename Vector::Type vectors[Vector::registers];
+    for(unsigned int v = 0; v < Vector::registers; ++v)
+    {
+        vectors[v] = Vector::load(source + v * Vector::lanes);
+    }
+    bitonic_sort_vectors_avx512<Vector>(vectors);
+    for(unsigned int v = 0; v < Vector::registers; ++v)
+    {
+        Vector::store(source + v * Vector::lanes, vectors[v]);
+    }
+
+    if(source == padded)
+    {
+        std::copy(padded, padded + count, block);
+    }
+}
+
+/// \brief AVX-512 version of \p bitonic_merge_scalar. The smallest vector of both runs is merged
+/// with the vector of the largest elements seen so far, the smaller half of the result is stored
+/// and the next vector is read from the run whose next element is smaller, until one of the runs
+/// has less than a vector left.
+template<typename Radix>
+BITONIC_SORT_TARGET("avx512f")
+void bitonic_merge_avx512(const Radix*      left,
+                          const std::size_t left_count,
+                          const Radix*      right,
+                          const std::size_t right_count,
+                          Radix*            output)
+{
+    using Vector                = BitonicVectorAvx512<Radix>;
+    constexpr std::size_t lanes = Vector::lanes;
+    if(left_count < lanes || right_count < lanes)
+    {
+        bitonic_merge_scalar(left, left_count, right, right_count, output);
+        return;
+    }
+
+    typename Vector::Type low  = Vector::load(left);
+    typename Vector::Type high = Vector::load(right);
+    std::size_t           l    = lanes;
+    std::size_t           r    = lanes;
+    bitonic_merge_vectors_avx512<Vector>(low, high);
+    Vector::store(output, low);
+    output += lanes;
+    while(l + lanes <= left_count && r + lanes <= right_count)
+    {
+        if(left[l] <= right[r])
+        {
+            low = Vector::load(left + l);
+            l += lanes;
+        }
+        else
+        {
+            low = Vector::load(right + r);
+            r += lanes;
+        }
+        bitonic_merge_vectors_avx512<Vector>(low, high);
+        Vector::store(output, low);
+        output += lanes;
+    }
+
+    Radix maximums[lanes];
+    Vector::store(maximums, high);
+    bitonic_merge_tail(maximums,
+                       lanes,
+                       left + l,
+                       left + left_count,
+                       right + r,
+                       right + right_count,
+                       output);
+}
+
+/// \brief Operations on vectors of 32-bit (\p std::uint32_t) or 64-bit (\p std::uint64_t)
+/// unsigned integers of the AVX2 instruction set.
+template<typename Radix>
+struct BitonicVectorAvx2;
+
+/// \brief Operations of \p BitonicVectorAvx2 that do not depend on the size of the lanes.
+struct BitonicVectorAvx2Base
+{
+    using Type = __m256i;
+
+    /// Number of vectors of a block sorted in registers, half of the 16 registers.
+    static constexpr unsigned int registers = 8;
+
+    BITONIC_SORT_TARGET("avx2") static Type load(const void* source)
+    {
+        return _mm256_loadu_si256(static_cast<const __m256i*>(source));
+    }
+
+    BITONIC_SORT_TARGET("avx2") static void store(void* destination, const Type vector)
+    {
+        _mm256_storeu_si256(static_cast<__m256i*>(destination), vector);
+    }
+
+    /// Moves word <tt>words[i]</tt> of \p vector to word i.
+    BITONIC_SORT_TARGET("avx2")
+    static Type permute(const Type vector, const std::uint32_t* words)
+    {
+        return _mm256_permutevar8x32_epi32(vector, load(words));
+    }
+
+    /// Takes the words of \p high that are set in \p high_words and the others of \p low.
+    BITONIC_SORT_TARGET("avx2")
+    static Type blend(const Type low, const Type high, const std::uint32_t* high_words)
+    {
+        return _mm256_blendv_epi8(low, high, load(high_words));
+    }
+};
+
+template<>
+struct BitonicVectorAvx2<std::uint32_t> : BitonicVectorAvx2Base
+{
+    static constexpr unsigned int            lanes  = 8;
+    static constexpr BitonicLaneTables<8, 1> tables = make_bitonic_lane_tables<8, 1>();
+
+    BITONIC_SORT_TARGET("avx2")
+    static void min_max(const Type a, const Type b, Type& minimum, Type& maximum)
+    {
+        minimum = _mm256_min_epu32(a, b);
+        maximum = _mm256_max_epu32(a, b);
+    }
+};
+
+/// AVX2 has no unsigned 64-bit minimum and maximum. They are selected with a signed comparison of
+/// the lanes with their sign bits flipped.
+template<>
+struct BitonicVectorAvx2<std::uint64_t> : BitonicVectorAvx2Base
+{
+    static constexpr unsigned int            lanes  = 4;
+    static constexpr BitonicLaneTables<8, 2> tables = make_bitonic_lane_tables<8, 2>();
+
+    BITONIC_SORT_TARGET("avx2")
+    static void min_max(const Type a, const Type b, Type& minimum, Type& maximum)
+    {
+        const __m256i sign_bits = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+        const __m256i greater   = _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign_bits),
+                                                   _mm256_xor_si256(b, sign_bits));
+        minimum                 = _mm256_blendv_epi8(a, b, greater);
+        maximum                 = _mm256_blendv_epi8(b, a, greater);
+    }
+};
+
+/// \brief AVX2 version of \p bitonic_exchange_avx512.
+template<typename Vector, bool Mirrored, unsigned int Stage>
+BITONIC_SORT_TARGET("avx2")
+inline typename Vector::Type bitonic_exchange_avx2(const typename Vector::Type vector)
+{
+    typename Vector::Type minimum, maximum;
+    Vector::min_max(vector,
+                    Vector::permute(vector, Vector::tables.partners[Mirrored][Stage]),
+                    minimum,
+                    maximum);
+    return Vector::blend(minimum, maximum, Vector::tables.high_words[Stage]);
+}
+
+/// \brief AVX2 version of \p bitonic_stages_avx512.
+template<typename Vector, unsigned int Width, unsigned int Distance>
+BITONIC_SORT_TARGET("avx2")
+inline void bitonic_stages_avx2(typename Vector::Type (&vectors)[Vector::registers])
+{
+    using Type                      = typename Vector::Type;
+    constexpr unsigned int lanes    = Vector::lanes;
+    constexpr bool         mirrored = Distance == Width / 2;
+    if constexpr(Distance >= lanes)
+    {
+        constexpr unsigned int vector_distance = Distance / lanes;
+        constexpr unsigned int block_vectors   = Width / lanes;
+        for(unsigned int v = 0; v < Vector::registers; ++v)
+        {
+            if((v & vector_distance) != 0)
+            {
+                continue;
+            }
+            const unsigned int partner = mirrored ? v ^ (block_vectors - 1) : v + vector_distance;
+            const Type         right
+                = mirrored ? Vector::permute(vectors[partner],
+                                             Vector::tables.partners[1][Vector::tables.stages - 1])
+                           : vectors[partner];
+            Type maximum;
+            Vector::min_max(vectors[v], right, vectors[v], maximum);
+            vectors[partner]
+                = mirrored ? Vector::permute(maximum,
+                                             Vector::tables.partners[1][Vector::tables.stages - 1])
+                           : maximum;
+        }
+    }
+    else
+    {
+        for(unsigned int v = 0; v < Vector::registers; ++v)
+        {
+            vectors[v]
+                = bitonic_exchange_avx2<Vector, mirrored, bitonic_log2(Distance)>(vectors[v]);
+        }
+    }
+    if constexpr(Distance > 1)
+    {
+        bitonic_stages_avx2<Vector, Width, Distance / 2>(vectors);
+    }
+}
+
+/// \brief AVX2 version of \p bitonic_sort_vectors_avx512.
+template<typename Vector, unsigned int Width = 2>
+BITONIC_SORT_TARGET("avx2")
+inline void bitonic_sort_vectors_avx2(typename Vector::Type (&vectors)[Vector::registers])
+{
+    bitonic_stages_avx2<Vector, Width, Width / 2>(vectors);
+    if constexpr(Width < Vector::registers * Vector::lanes)
+    {
+        bitonic_sort_vectors_avx2<Vector, Width * 2>(vectors);
+    }
+}
+
+/// \brief AVX2 version of \p bitonic_clean_avx512.
+template<typename Vector, unsigned int Stage>
+BITONIC_SORT_TARGET("avx2")
+inline void bitonic_clean_avx2(typename Vector::Type& low, typename Vector::Type& high)
+{
+    low  = bitonic_exchange_avx2<Vector, false, Stage>(low);
+    high = bitonic_exchange_avx2<Vector, false, Stage>(high);
+    if constexpr(Stage > 0)
+    {
+        bitonic_clean_avx2<Vector, Stage - 1>(low, high);
+    }
+}
+
+/// \brief AVX2 version of \p bitonic_merge_vectors_avx512.
+template<typename Vector>
+BITONIC_SORT_TARGET("avx2")
+inline void bitonic_merge_vectors_avx2(typename Vector::Type& low, typename Vector::Type& high)
+{
+    Vector::min_max(low,
+                    Vector::permute(high, Vector::tables.partners[1][Vector::tables.stages - 1]),
+                    low,
+                    high);
+    bitonic_clean_avx2<Vector, Vector::tables.stages - 1>(low, high);
+}
+
+/// \brief AVX2 version of \p bitonic_sort_block_scalar, which sorts blocks of 8 vectors.
+template<typename Radix>
+BITONIC_SORT_TARGET("avx2")
+void bitonic_sort_block_avx2(Radix* block, const std::size_t count)
+{
+    using Vector                     = BitonicVectorAvx2<Radix>;
+    constexpr std::size_t block_size = Vector::registers * Vector::lanes;
+
+    Radix  padded[block_size];
+    Radix* source = block;
+    if(count < block_size)
+    {
+        std::copy(block, block + count, padded);
+        std::fill(padded + count, padded + block_size, std::numeric_limits<Radix>::max());
+        source = padded;
+    }
+
+    typename Vector::Type vectors[Vector::registers];
+    for(unsigned int v = 0; v < Vector::registers; ++v)
+    {
+        vectors[v] = Vector::load(source + v * Vector::lanes);
+    }
+    bitonic_sort_vectors_avx2<Vector>(vectors);
+    for(unsigned int v = 0; v < Vector::registers; ++v)
+    {
+        Vector::store(source + v * Vector::lanes, vectors[v]);
+    }
+
+    if(source == padded)
+    {
+        std::copy(padded, padded + count, block);
+    }
+}
+
+/// \brief AVX2 version of \p bitonic_merge_avx512.
+template<typename Radix>
+BITONIC_SORT_TARGET("avx2")
+void bitonic_merge_avx2(const Radix*      left,
+                        const std::size_t left_count,
+                        const Radix*      right,
+                        const std::size_t right_count,
+                        Radix*            output)
+{
+    using Vector                = BitonicVectorAvx2<Radix>;
+    constexpr std::size_t lanes = Vector::lanes;
+    if(left_count < lanes || right_count < lanes)
+    {
+        bitonic_merge_scalar(left, left_count, right, right_count, output);
+        return;
+    }
+
+    typename Vector::Type low  = Vector::load(left);
+    typename Vector::Type high = Vector::load(right);
+    std::size_t           l    = lanes;
+    std::size_t           r    = lanes;
+    bitonic_merge_vectors_avx2<Vector>(low, high);
+    Vector::store(output, low);
+    output += lanes;
+    while(l + lanes <= left_count && r + lanes <= right_count)
+    {
+        if(left[l] <= right[r])
+        {
+            low = Vector::load(left + l);
+            l += lanes;
+        }
+        else
+        {
+            low = Vector::load(right + r);
+            r += lanes;
+        }
+        bitonic_merge_vectors_avx2<Vector>(low, high);
+        Vector::store(output, low);
+        output += lanes;
+    }
+
+    Radix maximums[lanes];
+    Vector::store(maximums, high);
+    bitonic_merge_tail(maximums,
+                       lanes,
+                       left + l,
+                       left + left_count,
+                       right + r,
+                       right + right_count,
+                       output);
+}
+#endif
+
+/// \brief Block sort and merge of the CPU sort engine for an instruction set, and the number of
+/// elements of the blocks that the block sort sorts at once.
+template<typename Radix>
+struct BitonicSimdEngine
+{
+    std::size_t                     block_size;
+    BitonicBlockSortFunction<Radix> sort_block;
+    BitonicMergeFunction<Radix>     merge;
+};
+
+/// \brief Returns the engine for \p level, or the scalar one if no vectorized version is
+/// available on this architecture. \p level must be supported by the host, which can be checked
+/// with \p get_host_simd_level.
+template<typename Radix>
+BitonicSimdEngine<Radix> get_bitonic_simd_engine(const SimdLevel level)
+{
+#ifdef BITONIC_SORT_X86_SIMD
+    switch(level)
+    {
+        case SimdLevel::avx512:
+            return {BitonicVectorAvx512<Radix>::registers * BitonicVectorAvx512<Radix>::lanes,
+                    bitonic_sort_block_avx512<Radix>,
+                    bitonic_merge_avx512<Radix>};
+        case SimdLevel::avx2:
+            return {BitonicVectorAvx2<Radix>::registers * BitonicVectorAvx2<Radix>::lanes,
+                    bitonic_sort_block_avx2<Radix>,
+                    bitonic_merge_avx2<Radix>};
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    return {256, bitonic_sort_block_scalar<Radix>, bitonic_merge_scalar<Radix>};
+}
+
+/// \brief Returns the number of elements that the merge of the sorted runs \p left and \p right
+/// takes from \p left for the first \p count elements of its output.
+template<typename Radix>
+std::size_t get_bitonic_merge_split(const Radix*      left,
+                                    const std::size_t left_count,
+                                    const Radix*      right,
+                                    const std::size_t right_count,
+                                    const std::size_t count)
+{
+    std::size_t first = count > right_count ? count - right_count : 0;
+    std::size_t last  = std::min(count, left_count);
+    while(first < last)
+    {
+        const std::size_t middle = (first + last) / 2;
+        if(left[middle] <= right[count - middle - 1])
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+/// \brief Merges the pairs of consecutive sorted runs of \p run_length elements of \p source, an
+/// array of \p length elements, into \p destination, restricted to the elements
+/// <tt>[begin, end)</tt> of \p destination. The elements of a pair that fall into the range are
+/// found by splitting the merge at both ends of the range, so that any range can be merged
+/// independently of the others.
+template<typename Radix>
+void bitonic_merge_level(const BitonicSimdEngine<Radix>& engine,
+                         const Radix*                    source,
+                         Radix*                          destination,
+                         const std::size_t               length,
+                         const std::size_t               run_length,
+                         const std::size_t               begin,
+                         const std::size_t               end)
+{
+    const std::size_t pair_length = 2 * run_length;
+    for(std::size_t pair_begin = begin / pair_length * pair_length; pair_begin < end;
+        pair_begin += pair_length)
+    {
+        const Radix* const left        = source + pair_begin;
+        const std::size_t  left_count  = std::min(run_length, length - pair_begin);
+        const Radix* const right       = left + left_count;
+        const std::size_t  right_count = std::min(run_length, length - pair_begin - left_count);
+
+        const std::size_t first = std::max(begin, pair_begin) - pair_begin;
+        const std::size_t last = std::min(end, pair_begin + left_count + right_count) - pair_begin;
+        const std::size_t left_first
+            = get_bitonic_merge_split(left, left_count, right, right_count, first);
+        const std::size_t left_last
+            = get_bitonic_merge_split(left, left_count, right, right_count, last);
+        engine.merge(left + left_first,
+                     left_last - left_first,
+                     right + (first - left_first),
+                     (last - left_last) - (first - left_first),
+                     destination + pair_begin + first);
+    }
+}
+
+/// \brief Sorts the \p length keys of \p keys on the CPU with \p threads threads (0 uses one per
+/// hardware thread) and the instructions of \p level. The keys are transformed into their radixes,
+/// inverted for a decreasing order, into \p radixes. The array is split into chunks small enough
+/// for their runs and merges to stay in the level 2 cache, and every thread sorts whole chunks:
+/// the blocks of a chunk are sorted in registers and then merged level by level with
+/// \p scratch. The remaining merge levels are shared by all threads, which merge consecutive
+/// parts of the output of every level. Finally, the radixes are transformed back into keys.
+template<typename Key>
+void bitonic_sort_simd(Key*                                               keys,
+                       const std::size_t                                  length,
+                       const bool                                         sort_increasing,
+                       const SimdLevel                                    level,
+                       const unsigned int                                 threads,
+                       std::vector<typename BitonicKeyTraits<Key>::Radix>& radixes,
+                       std::vector<typename BitonicKeyTraits<Key>::Radix>& scratch)
+{
+    using Traits = BitonicKeyTraits<Key>;
+    using Radix  = typename Traits::Radix;
+
+    const BitonicSimdEngine<Radix> engine = get_bitonic_simd_engine<Radix>(level);
+    const Radix                    invert = sort_increasing ? Radix{0} : ~Radix{0};
+    radixes.resize(length);
+    scratch.resize(length);
+
+    // A chunk and the output of its merges take at most half of the level 2 cache.
+    const std::size_t cache_size = get_host_l2_cache_size();
+    std::size_t       chunk_size = engine.block_size;
+    unsigned int      chunk_levels{};
+    while(4 * chunk_size * sizeof(Radix) <= cache_size && chunk_size < length)
+    {
+        chunk_size *= 2;
+        ++chunk_levels;
+    }
+
+    parallel_for(length,
+                 chunk_size,
+                 threads,
+                 [&](const std::size_t begin, const std::size_t end)
+                 {
+                     for(std::size_t chunk = begin; chunk < end; chunk += chunk_size)
+                     {
+                         const std::size_t chunk_end = std::min(chunk + chunk_size, end);
+                         for(std::size_t i = chunk; i < chunk_end; ++i)
+                         {
+                             radixes[i] = Traits::to_radix(keys[i]) ^ invert;
+                         }
+                         for(std::size_t block = chunk; block < chunk_end;
+                             block += engine.block_size)
+                         {
+                             engine.sort_block(radixes.data() + block,
+                                               std::min(engine.block_size, chunk_end - block));
+                         }
+
+                         // Every chunk executes the same number of merge levels, so that all of
+                         // them end in the same array.
+                         Radix* source      = radixes.data();
+                         Radix* destination = scratch.data();
+                         for(std::size_t run = engine.block_size; run < chunk_size; run *= 2)
+                         {
+                             bitonic_merge_level(engine,
+                                                 source,
+                                                 destination,
+                                                 length,
+                                                 run,
+                                                 chunk,
+                                                 chunk_end);
+                             std::swap(source, destination);
+                         }
+                     }
+                 });
+
+    Radix* source      = radixes.data();
+    Radix* destination = scratch.data();
+    if(chunk_levels % 2 != 0)
+    {
+        std::swap(source, destination);
+    }
+    for(std::size_t run = chunk_size; run < length; run *= 2)
+    {
+        parallel_for(length,
+                     engine.block_size,
+                     threads,
+                     [&](const std::size_t begin, const std::size_t end) {
+                         bitonic_merge_level(engine, source, destination, length, run, begin, end);
+                     });
+        std::swap(source, destination);
+    }
+
+    parallel_for(length,
+                 engine.block_size,
+                 threads,
+                 [&](const std::size_t begin, const std::size_t end)
+                 {
+                     for(std::size_t i = begin; i < end; ++i)
+                     {
+                         keys[i] = Traits::from_radix(source[i] ^ invert);
+                     }
+                 });
+}
+
+#endif // _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_SIMD_HPP
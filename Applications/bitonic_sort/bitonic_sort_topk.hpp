@@ -0,0 +1,409 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_TOPK_HPP
+#define _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_TOPK_HPP
+
+#include "bitonic_sort_keys.hpp"
+#include "bitonic_sort_segmented.hpp"
+#include "bitonic_sort_simd.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <hip/hip_runtime.h>
+
+/// \brief Length of the tiles that every block of the top-k kernel reduces in shared memory to the
+/// sorted buffer of their first keys.
+constexpr unsigned int bitonic_topk_tile_length = 4096;
+
+/// \brief Largest number of keys that the top-k selection returns. Every tile holds at least two
+/// buffers, so that every level of the hierarchical reduction shrinks the candidates.
+constexpr unsigned int bitonic_topk_max_count = bitonic_topk_tile_length / 2;
+
+/// \brief Returns the length of the sorted buffers that hold the first \p count keys: the next
+/// power of two.
+inline unsigned int get_bitonic_topk_buffer_length(const unsigned int count)
+{
+    unsigned int length = 1;
+    while(length < count)
+    {
+        length *= 2;
+    }
+    return length;
+}
+
+/// \brief Returns the rank of \p key in the order of the sort: its radix, inverted for decreasing
+/// order, so that the first keys of the sorted array always have the smallest ranks. Ranks are
+/// widened to 64 bits, the type of the thresholds.
+template<typename Key>
+__host__ __device__ inline std::uint64_t get_bitonic_topk_rank(const Key  key,
+                                                               const bool sort_increasing)
+{
+    using Radix       = typename BitonicKeyTraits<Key>::Radix;
+    const Radix radix = BitonicKeyTraits<Key>::to_radix(key);
+    return sort_increasing ? radix : static_cast<Radix>(~radix);
+}
+
+/// \brief Level of the hierarchical top-k selection on the device: the input of \p length
+/// elements is reduced to one sorted buffer for each of its \p tiles tiles.
+struct BitonicTopKLevel
+{
+    unsigned int length;
+    unsigned int tiles;
+};
+
+/// \brief Plan of the top-k selection of the first \p count keys of an array of \p length keys.
+/// The first level reduces the tiles of the array, and every further level the tiles of the
+/// buffers of the previous one, until a single buffer remains.
+struct BitonicTopKPlan
+{
+    unsigned int                  length;
+    unsigned int                  count;
+    unsigned int                  buffer_length;
+    std::vector<BitonicTopKLevel> levels;
+};
+
+/// \brief Builds the \p BitonicTopKPlan of the first \p count keys, at most
+/// \p bitonic_topk_max_count, of an array of \p length keys.
+inline BitonicTopKPlan make_bitonic_topk_plan(const unsigned int length, const unsigned int count)
+{
+    BitonicTopKPlan plan{length, count, get_bitonic_topk_buffer_length(count), {}};
+    unsigned int    level_length = length;
+    unsigned int    tiles;
+    do
+    {
+        tiles = std::max(1u, ceiling_div(level_length, bitonic_topk_tile_length));
+        plan.levels.push_back({level_length, tiles});
+        level_length = tiles * plan.buffer_length;
+    }
+    while(tiles > 1);
+    return plan;
+}
+
+/// \brief Words of the top-k selection on the host for keys of radix \p Radix: the rank of a key
+/// and its index, so that the words order like the ranks and the selected keys can be gathered
+/// with their values. 32-bit ranks are packed with the index into a 64-bit word, which the CPU
+/// sort engine sorts, wider ranks are paired with it.
+template<typename Radix>
+struct BitonicTopKWord
+{
+    using Type = std::pair<std::uint64_t, unsigned int>;
+
+    static Type make(const std::uint64_t rank, const unsigned int index)
+    {
+        return {rank, index};
+    }
+
+    static unsigned int get_index(const Type& word)
+    {
+        return word.second;
+    }
+
+    static std::uint64_t get_rank(const Type& word)
+    {
+        return word.first;
+    }
+
+    /// \brief Word of the empty places of the buffers, greater than every word of a key.
+    static Type get_padding()
+    {
+        return {std::numeric_limits<std::uint64_t>::max(),
+                std::numeric_limits<unsigned int>::max()};
+    }
+};
+
+template<>
+struct BitonicTopKWord<std::uint32_t>
+{
+    using Type = std::uint64_t;
+
+    static Type make(const std::uint64_t rank, const unsigned int index)
+    {
+        return rank << 32 | index;
+    }
+
+    static unsigned int get_index(const Type word)
+    {
+        return static_cast<unsigned int>(word);
+    }
+
+    static std::uint64_t get_rank(const Type word)
+    {
+        return word >> 32;
+    }
+
+    static Type get_padding()
+    {
+        return std::numeric_limits<Type>::max();
+    }
+};
+
+/// \brief Keeps the \p length smallest words of the sorted runs \p left and \p right in \p left:
+/// the smaller of every word of \p left and the mirrored word of \p right, which is the first
+/// stage of the bitonic merge of the two runs. The result is a bitonic sequence.
+template<typename Word>
+void bitonic_topk_reduce(Word* left, const Word* right, const unsigned int length)
+{
+    for(unsigned int i = 0; i < length; ++i)
+    {
+        left[i] = std::min(left[i], right[length - 1 - i]);
+    }
+}
+
+/// \brief Sorts the bitonic sequence \p words of \p length words, a power of two, increasingly
+/// with the remaining stages of the bitonic merge, which compare words at half the distance of
+/// the previous stage.
+template<typename Word>
+void bitonic_topk_clean(Word* words, const unsigned int length)
+{
+    for(unsigned int distance = length / 2; distance > 0; distance /= 2)
+    {
+        for(unsigned int block = 0; block < length; block += 2 * distance)
+        {
+            for(unsigned int i = block; i < block + distance; ++i)
+            {
+                const Word left     = words[i];
+                const Word right    = words[i + distance];
+                words[i]            = std::min(left, right);
+                words[i + distance] = std::max(left, right);
+            }
+        }
+    }
+}
+
+/// \brief Top-k selection on the host, the counterpart of the top-k kernel. The array is split
+/// into chunks, and every range of chunks that a thread selects keeps a sorted buffer of the
+/// first keys that it has seen. Keys whose rank is above the threshold, the greatest rank of the
+/// first \p count keys of any buffer, are pruned right away. The others are collected into a
+/// batch, which is sorted and reduced into the buffer once it is full. The buffers are then
+/// reduced hierarchically.
+template<typename Key>
+class BitonicTopKSelector
+{
+public:
+    using Radix      = typename BitonicKeyTraits<Key>::Radix;
+    using WordTraits = BitonicTopKWord<Radix>;
+    using Word       = typename WordTraits::Type;
+
+    /// \brief Number of keys of every chunk.
+    static constexpr unsigned int chunk_length = 1u << 16;
+
+    /// \brief Prepares the selection of the first \p count keys, at most
+    /// \p bitonic_topk_max_count, of arrays of \p length keys sorted increasingly if
+    /// \p sort_increasing is true, with the CPU sort engine of \p level.
+    BitonicTopKSelector(const unsigned int length,
+                        const unsigned int count,
+                        const bool         sort_increasing,
+                        const SimdLevel    level)
+        : length(length)
+        , count(count)
+        , buffer_length(get_bitonic_topk_buffer_length(count))
+        , chunks(std::max(1u, ceiling_div(length, chunk_length)))
+        , sort_increasing(sort_increasing)
+        , engine(get_bitonic_simd_engine<std::uint64_t>(level))
+        , buffers(static_cast<std::size_t>(chunks) * buffer_length)
+    {
+        reset();
+    }
+
+    BitonicTopKSelector(const BitonicTopKSelector&)            = delete;
+    BitonicTopKSelector& operator=(const BitonicTopKSelector&) = delete;
+
+    /// \brief Clears the threshold and the number of candidates before a new selection.
+    void reset()
+    {
+        threshold  = std::numeric_limits<std::uint64_t>::max();
+        candidates = 0;
+    }
+
+    unsigned int get_chunk_count() const
+    {
+        return chunks;
+    }
+
+    /// \brief Returns the number of keys that passed the threshold and were sorted.
+    std::size_t get_candidate_count() const
+    {
+        return candidates;
+    }
+
+    /// \brief Returns the number of keys that the selection returns.
+    unsigned int get_selected_count() const
+    {
+        return std::min(count, length);
+    }
+
+    /// \brief Selects the first keys of the chunks <tt>[begin, end)</tt> of \p keys into the
+    /// buffer of chunk \p begin, and empties the buffers of the other chunks, so that the
+    /// threshold of the buffer keeps falling over the whole range. Disjoint ranges of chunks can
+    /// be selected concurrently.
+    void select_chunks(const Key* keys, const std::size_t begin, const std::size_t end)
+    {
+        Word* const buffer = buffers.data() + begin * buffer_length;
+        std::fill(buffer, buffers.data() + end * buffer_length, WordTraits::get_padding());
+
+        std::vector<Word> batch;
+        std::vector<Word> scratch;
+        std::size_t       range_candidates = 0;
+        batch.reserve(buffer_length);
+
+        const unsigned int first = static_cast<unsigned int>(begin) * chunk_length;
+        const unsigned int last  = std::min<std::size_t>(length, end * chunk_length);
+        std::uint64_t      bound = threshold.load(std::memory_order_relaxed);
+        for(unsigned int i = first; i < last; ++i)
+        {
+            const std::uint64_t rank = get_bitonic_topk_rank(keys[i], sort_increasing);
+            if(rank > bound)
+            {
+                continue;
+            }
+            batch.push_back(WordTraits::make(rank, i));
+            if(batch.size() == buffer_length)
+            {
+                range_candidates += batch.size();
+                bound = reduce_batch(buffer, batch, scratch);
+            }
+        }
+        if(!batch.empty())
+        {
+            range_candidates += batch.size();
+            reduce_batch(buffer, batch, scratch);
+        }
+        candidates += range_candidates;
+    }
+
+    /// \brief Reduces the buffers of all chunks pairwise, level by level, into the buffer of the
+    /// first chunk.
+    void merge_chunks()
+    {
+        for(std::size_t stride = 1; stride < chunks; stride *= 2)
+        {
+            for(std::size_t chunk = 0; chunk + stride < chunks; chunk += 2 * stride)
+            {
+                // The buffers of all but the first chunk of a selected range are empty.
+                Word* const buffer = buffers.data() + chunk * buffer_length;
+                Word* const other  = buffer + stride * buffer_length;
+                if(other[0] != WordTraits::get_padding())
+                {
+                    bitonic_topk_reduce(buffer, other, buffer_length);
+                    bitonic_topk_clean(buffer, buffer_length);
+                }
+            }
+        }
+    }
+
+    /// \brief Writes the selected keys of \p keys in order to \p selected_keys and, if
+    /// \p values is not null, their values to \p selected_values.
+    template<typename Value>
+    void gather(const Key*   keys,
+                const Value* values,
+                Key*         selected_keys,
+                Value*       selected_values) const
+    {
+        for(unsigned int i = 0; i < get_selected_count(); ++i)
+        {
+            const unsigned int index = WordTraits::get_index(buffers[i]);
+            selected_keys[i]         = keys[index];
+            if(values != nullptr)
+            {
+                selected_values[i] = values[index];
+            }
+        }
+    }
+
+private:
+    /// \brief Sorts \p batch, padded to the length of the buffer, reduces it into \p buffer and
+    /// empties it. Returns the threshold after lowering it to the greatest rank of the first keys
+    /// of the buffer.
+    std::uint64_t
+        reduce_batch(Word* const buffer, std::vector<Word>& batch, std::vector<Word>& scratch)
+    {
+        batch.resize(buffer_length, WordTraits::get_padding());
+        if constexpr(std::is_same_v<Word, std::uint64_t>)
+        {
+            bitonic_sort_words(engine, batch.data(), buffer_length, scratch);
+        }
+        else
+        {
+            std::sort(batch.begin(), batch.end());
+        }
+        bitonic_topk_reduce(buffer, batch.data(), buffer_length);
+        bitonic_topk_clean(buffer, buffer_length);
+        batch.clear();
+
+        std::uint64_t bound = threshold.load(std::memory_order_relaxed);
+        if(buffer[count - 1] != WordTraits::get_padding())
+        {
+            const std::uint64_t rank = WordTraits::get_rank(buffer[count - 1]);
+            while(rank < bound && !threshold.compare_exchange_weak(bound, rank))
+            {}
+            bound = std::min(bound, rank);
+        }
+        return bound;
+    }
+
+    unsigned int                     length;
+    unsigned int                     count;
+    unsigned int                     buffer_length;
+    unsigned int                     chunks;
+    bool                             sort_increasing;
+    BitonicSimdEngine<std::uint64_t> engine;
+    std::vector<Word>                buffers;
+    std::atomic<std::uint64_t>       threshold;
+    std::atomic<std::size_t>         candidates;
+};
+
+/// \brief Writes the first \p count keys, at most \p bitonic_topk_max_count, of the \p length
+/// keys of \p keys in the order of the sort to \p selected_keys and, if \p values is not null,
+/// their values to \p selected_values, with a \p BitonicTopKSelector whose chunks are split
+/// among \p threads host threads. Returns the number of keys that passed the threshold.
+template<typename Key, typename Value>
+std::size_t bitonic_topk_cpu(const Key*         keys,
+                             const Value*       values,
+                             const unsigned int length,
+                             const unsigned int count,
+                             const bool         sort_increasing,
+                             const SimdLevel    level,
+                             const unsigned int threads,
+                             Key*               selected_keys,
+                             Value*             selected_values)
+{
+    BitonicTopKSelector<Key> selector(length, count, sort_increasing, level);
+    parallel_for(selector.get_chunk_count(),
+                 1,
+                 threads,
+                 [&](const std::size_t begin, const std::size_t end)
+                 { selector.select_chunks(keys, begin, end); });
+    selector.merge_chunks();
+    selector.gather(keys, values, selected_keys, selected_values);
+    return selector.get_candidate_count();
+}
+
+#endif // _APPLICATIONS_BITONIC_SORT_BITONIC_SORT_TOPK_HPP
@@ -0,0 +1,249 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_CONVOLUTION_CONVOLUTION_BATCHED_HPP
+#define _APPLICATIONS_CONVOLUTION_CONVOLUTION_BATCHED_HPP
+
+#include "convolution_boundary.hpp"
+#include "convolution_cpu.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/// \brief Dimensions of a batched convolution, which applies a bank of \p filters filters, each
+/// with one \p mask_width x \p mask_width mask per channel, to a batch of \p batch images of
+/// \p channels channels of \p width x \p height elements.
+///
+/// The images are stored in NCHW order: image by image, channel by channel, row by row. The
+/// masks are stored filter by filter and channel by channel, and the output in the same order as
+/// the images, with one channel per filter. Output channel f of an image is the sum over the
+/// channels c of the convolution of channel c with mask c of filter f.
+struct BatchedConvolutionShape
+{
+    unsigned int batch      = 1;
+    unsigned int channels   = 1;
+    unsigned int filters    = 1;
+    unsigned int width      = 0;
+    unsigned int height     = 0;
+    unsigned int mask_width = 0;
+
+    /// \brief Number of elements of a channel.
+    std::size_t plane_size() const
+    {
+        return static_cast<std::size_t>(width) * height;
+    }
+
+    /// \brief Number of elements of the input batch.
+    std::size_t input_size() const
+    {
+        return plane_size() * channels * batch;
+    }
+
+    /// \brief Number of elements of the output batch.
+    std::size_t output_size() const
+    {
+        return plane_size() * filters * batch;
+    }
+
+    /// \brief Number of elements of the masks of a filter.
+    std::size_t filter_size() const
+    {
+        return static_cast<std::size_t>(mask_width) * mask_width * channels;
+    }
+
+    /// \brief Number of multiply-adds of the convolution of the whole batch.
+    double multiply_adds() const
+    {
+        return static_cast<double>(output_size()) * filter_size();
+    }
+};
+
+/// \brief Number of output rows that \p convolution_batched_direct_cpu computes at once.
+constexpr unsigned int batched_convolution_block_rows = 32;
+
+/// \brief Default size in bytes of the column buffer of \p convolution_batched_im2col_cpu.
+constexpr std::size_t batched_convolution_im2col_bytes = std::size_t{8} << 20;
+
+/// \brief Multithreaded direct batched convolution of \p input with the masks in \p filter_bank
+/// (see \p BatchedConvolutionShape), where the elements outside of the channels are derived with
+/// \p boundary.
+///
+/// Every output channel is computed in blocks of \p batched_convolution_block_rows rows, each in
+/// one pass over the output: the convolution of the first input channel is written to the block
+/// by the tile kernels of \p convolution_direct_cpu, and those of the other channels are added to
+/// it while it is still in the cache. The blocks of all filters for the same rows of an image
+/// are consecutive work items, so that the input rows they read are shared in the cache, and the
+/// work items are split across \p num_threads host threads (by default,
+/// \p get_default_host_threads()). The tiles are computed with \p simd_level, which is lowered to
+/// the level supported by the host if necessary. Every level adds up the products of a channel
+/// in the same order, and the channels in order, so the results do not depend on it.
+inline void convolution_batched_direct_cpu(float*                         output,
+                                           const float*                   input,
+                                           const float*                   filter_bank,
+                                           const BatchedConvolutionShape& shape,
+                                           const BoundaryMode             boundary,
+                                           const unsigned int             num_threads = 0,
+                                           const SimdLevel simd_level = get_host_simd_level())
+{
+    const ConvolutionTileFunction convolution_tile
+        = get_convolution_tile_function(std::min(simd_level, get_host_simd_level()),
+                                        shape.mask_width);
+    const std::size_t plane_size  = shape.plane_size();
+    const std::size_t mask_size   = static_cast<std::size_t>(shape.mask_width) * shape.mask_width;
+    const std::size_t blocks      = ceiling_div(shape.height, batched_convolution_block_rows);
+    const std::size_t block_items = blocks * shape.filters;
+
+    const auto process_items = [&](const std::size_t item_begin, const std::size_t item_end)
+    {
+        std::vector<float> block;
+        std::vector<float> partial;
+        for(std::size_t item = item_begin; item < item_end; ++item)
+        {
+            const std::size_t image     = item / block_items;
+            const std::size_t row_begin = item % block_items / shape.filters
+                                          * batched_convolution_block_rows;
+            const std::size_t filter    = item % shape.filters;
+            const std::size_t row_end
+                = std::min<std::size_t>(shape.height, row_begin + batched_convolution_block_rows);
+            const std::size_t block_size = (row_end - row_begin) * shape.width;
+
+            float* const out = output + (image * shape.filters + filter) * plane_size
+                               + row_begin * shape.width;
+            partial.resize(block_size);
+            for(std::size_t channel = 0; channel < shape.channels; ++channel)
+            {
+                const float* const     channel_data
+                    = input + (image * shape.channels + channel) * plane_size;
+                const ConvolutionInput plane{channel_data, shape.width, shape.height, boundary};
+                convolution_direct_rows(channel == 0 ? out : partial.data(),
+                                        plane,
+                                        filter_bank
+                                            + (filter * shape.channels + channel) * mask_size,
+                                        shape.mask_width,
+                                        convolution_tile,
+                                        row_begin,
+                                        row_end,
+                                        block);
+                if(channel != 0)
+                {
+                    for(std::size_t i = 0; i < block_size; ++i)
+                    {
+                        out[i] += partial[i];
+                    }
+                }
+            }
+        }
+    };
+    parallel_for(shape.batch * block_items, 1, num_threads, process_items);
+}
+
+/// \brief Multithreaded batched convolution of \p input with the masks in \p filter_bank (see
+/// \p BatchedConvolutionShape) as a matrix product, where the elements outside of the channels
+/// are derived with \p boundary.
+///
+/// The rows of every image are processed in blocks, whose input elements are rearranged into a
+/// column buffer (im2col) of at most \p buffer_bytes bytes: for each of the
+/// <tt>channels * mask_width * mask_width</tt> elements of a filter, row i of the buffer holds the
+/// input element that it is multiplied with for every output element of the block. The output
+/// elements of the block of all filters are then the product of the buffer and the filter bank,
+/// computed by the cache-blocked \p multiply_matrices with \p num_threads host threads (by
+/// default, \p get_default_host_threads()), which also build the buffer. Each input element is
+/// copied <tt>mask_width * mask_width</tt> times, but all filters are applied to it at the full
+/// rate of the matrix product, so this pays off for banks of many filters over many channels.
+///
+/// The elements of the product are indexed with \p int, so the output of an image must have
+/// fewer than 2^31 elements.
+inline void convolution_batched_im2col_cpu(float*                         output,
+                                           const float*                   input,
+                                           const float*                   filter_bank,
+                                           const BatchedConvolutionShape& shape,
+                                           const BoundaryMode             boundary,
+                                           const unsigned int             num_threads = 0,
+                                           const std::size_t buffer_bytes
+                                           = batched_convolution_im2col_bytes)
+{
+    const std::size_t    plane_size  = shape.plane_size();
+    const std::size_t    filter_size = shape.filter_size();
+    const std::size_t    mask_width  = shape.mask_width;
+    const std::ptrdiff_t radius      = shape.mask_width / 2;
+
+    // Number of rows of the blocks, such that the column buffer fits in buffer_bytes.
+    const std::size_t block_rows = std::min<std::size_t>(
+        shape.height,
+        std::max<std::size_t>(1, buffer_bytes / (filter_size * shape.width * sizeof(float))));
+    std::vector<float> columns(block_rows * shape.width * filter_size);
+
+    for(std::size_t image = 0; image < shape.batch; ++image)
+    {
+        for(std::size_t row_begin = 0; row_begin < shape.height; row_begin += block_rows)
+        {
+            const std::size_t rows = std::min<std::size_t>(block_rows, shape.height - row_begin);
+            const std::size_t block_size = rows * shape.width;
+
+            // Row i of the buffer is the input channel c, shifted by the offset (dx, dy) of
+            // element i of the filter.
+            const auto im2col = [&](const std::size_t i_begin, const std::size_t i_end)
+            {
+                for(std::size_t i = i_begin; i < i_end; ++i)
+                {
+                    const std::size_t channel = i / (mask_width * mask_width);
+                    const auto dy = static_cast<std::ptrdiff_t>(i / mask_width % mask_width);
+                    const auto dx = static_cast<std::ptrdiff_t>(i % mask_width);
+                    const float* const channel_data
+                        = input + (image * shape.channels + channel) * plane_size;
+                    const ConvolutionInput plane{channel_data, shape.width, shape.height, boundary};
+                    for(std::size_t y = 0; y < rows; ++y)
+                    {
+                        load_input_row(plane,
+                                       static_cast<std::ptrdiff_t>(row_begin + y) + dy - radius,
+                                       dx - radius,
+                                       shape.width,
+                                       columns.data() + i * block_size + y * shape.width);
+                    }
+                }
+            };
+            parallel_for(filter_size, 1, num_threads, im2col);
+
+            // Output element (p, f) of the block is the dot product of column p of the buffer and
+            // filter f.
+            multiply_matrices<float>(1.0f,
+                                     0.0f,
+                                     static_cast<int>(block_size),
+                                     static_cast<int>(shape.filters),
+                                     static_cast<int>(filter_size),
+                                     columns.data(),
+                                     1,
+                                     static_cast<int>(block_size),
+                                     filter_bank,
+                                     1,
+                                     static_cast<int>(filter_size),
+                                     output + image * shape.filters * plane_size
+                                         + row_begin * shape.width,
+                                     static_cast<int>(plane_size),
+                                     num_threads);
+        }
+    }
+}
+
+#endif // _APPLICATIONS_CONVOLUTION_CONVOLUTION_BATCHED_HPP
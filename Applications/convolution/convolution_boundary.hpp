@@ -0,0 +1,176 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_CONVOLUTION_CONVOLUTION_BOUNDARY_HPP
+#define _APPLICATIONS_CONVOLUTION_CONVOLUTION_BOUNDARY_HPP
+
+#include <hip/hip_runtime.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+/// \brief Boundary conditions of the convolution: how the elements outside of the grid, which
+/// the mask covers near its edges, are derived from the elements of the grid.
+enum class BoundaryMode
+{
+    /// The elements outside of the grid are zero.
+    zero,
+    /// The nearest element of the grid is repeated: <tt>aaa|abcd|ddd</tt>.
+    clamp,
+    /// The grid is reflected at its edges, including the edge element: <tt>cba|abcd|dcb</tt>.
+    mirror,
+    /// The grid is repeated periodically: <tt>bcd|abcd|abc</tt>.
+    wrap
+};
+
+/// \brief Returns the name of a \p BoundaryMode, as accepted by \p parse_boundary_mode.
+inline const char* boundary_mode_name(const BoundaryMode boundary)
+{
+    switch(boundary)
+    {
+        case BoundaryMode::clamp: return "clamp";
+        case BoundaryMode::mirror: return "mirror";
+        case BoundaryMode::wrap: return "wrap";
+        default: return "zero";
+    }
+}
+
+/// \brief Parses the \p name of a boundary mode into \p boundary. Returns false if the name is
+/// unknown.
+inline bool parse_boundary_mode(const std::string& name, BoundaryMode& boundary)
+{
+    for(const BoundaryMode mode :
+        {BoundaryMode::zero, BoundaryMode::clamp, BoundaryMode::mirror, BoundaryMode::wrap})
+    {
+        if(name == boundary_mode_name(mode))
+        {
+            boundary = mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// \brief Returns the index of the element of a dimension of \p size elements that element
+/// \p index stands for with the boundary mode \p boundary, or -1 if it is zero. Indices inside
+/// the dimension are returned unchanged, others may lie any distance outside of it.
+__host__ __device__ inline std::ptrdiff_t resolve_boundary_index(const std::ptrdiff_t index,
+                                                                 const std::ptrdiff_t size,
+                                                                 const BoundaryMode   boundary)
+{
+    if(index >= 0 && index < size)
+    {
+        return index;
+    }
+    switch(boundary)
+    {
+        case BoundaryMode::clamp: return index < 0 ? 0 : size - 1;
+        case BoundaryMode::mirror:
+        {
+            const std::ptrdiff_t period    = 2 * size;
+            const std::ptrdiff_t remainder = (index % period + period) % period;
+            return remainder < size ? remainder : period - 1 - remainder;
+        }
+        case BoundaryMode::wrap: return (index % size + size) % size;
+        default: return -1;
+    }
+}
+
+/// \brief Unpadded input grid of a convolution: \p width x \p height elements, stored row by
+/// row from \p data, whose elements outside of the grid are derived with \p boundary.
+///
+/// Up to \p halo_rows rows above and below the grid may be stored in front of and after it
+/// instead, as for a band of a larger grid, whose rows beyond its edges are the rows of the
+/// neighbouring bands. Further rows are derived from the rows of the grid.
+struct ConvolutionInput
+{
+    const float* data      = nullptr;
+    unsigned int width     = 0;
+    unsigned int height    = 0;
+    BoundaryMode boundary  = BoundaryMode::zero;
+    unsigned int halo_rows = 0;
+
+    /// \brief Returns row \p y, which can be a stored halo row, or null if it is outside of the
+    /// grid and zero.
+    const float* row(std::ptrdiff_t y) const
+    {
+        const std::ptrdiff_t halo = halo_rows;
+        if(y < -halo || y >= height + halo)
+        {
+            y = resolve_boundary_index(y, height, boundary);
+            if(y < 0)
+            {
+                return nullptr;
+            }
+        }
+        return data + y * static_cast<std::ptrdiff_t>(width);
+    }
+};
+
+/// \brief Copies the \p count elements of \p row, a row of \p width elements, from column
+/// \p x_begin on to \p destination. The part inside the row is copied as a whole, only the
+/// elements outside of it are derived one at a time with \p boundary.
+template<typename T>
+void load_boundary_row(const T*             row,
+                       const std::ptrdiff_t width,
+                       const BoundaryMode   boundary,
+                       const std::ptrdiff_t x_begin,
+                       const std::size_t    count,
+                       T*                   destination)
+{
+    // Elements [inside_begin, inside_end) of the destination are inside the row.
+    const std::ptrdiff_t end          = x_begin + static_cast<std::ptrdiff_t>(count);
+    const std::ptrdiff_t inside_begin = std::min(end, std::max<std::ptrdiff_t>(0, x_begin));
+    const std::ptrdiff_t inside_end   = std::max(inside_begin, std::min(end, width));
+    std::copy(row + inside_begin, row + inside_end, destination + (inside_begin - x_begin));
+
+    const auto load_outside = [&](const std::ptrdiff_t first, const std::ptrdiff_t last)
+    {
+        for(std::ptrdiff_t x = first; x < last; ++x)
+        {
+            const std::ptrdiff_t column = resolve_boundary_index(x, width, boundary);
+            destination[x - x_begin]    = column < 0 ? T{} : row[column];
+        }
+    };
+    load_outside(x_begin, inside_begin);
+    load_outside(inside_end, end);
+}
+
+/// \brief Copies the \p count elements of row \p y of \p input from column \p x_begin on to
+/// \p destination (see \p load_boundary_row).
+inline void load_input_row(const ConvolutionInput& input,
+                           const std::ptrdiff_t    y,
+                           const std::ptrdiff_t    x_begin,
+                           const std::size_t       count,
+                           float*                  destination)
+{
+    const float* const row = input.row(y);
+    if(row == nullptr)
+    {
+        std::fill(destination, destination + count, 0.0f);
+        return;
+    }
+    load_boundary_row(row, input.width, input.boundary, x_begin, count, destination);
+}
+
+#endif // _APPLICATIONS_CONVOLUTION_CONVOLUTION_BOUNDARY_HPP
@@ -0,0 +1,262 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_CONVOLUTION_CONVOLUTION_CPU_HPP
+#define _APPLICATIONS_CONVOLUTION_CONVOLUTION_CPU_HPP
+
+#include "convolution_boundary.hpp"
+#include "convolution_simd.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/// \brief Signature of the direct convolution of a tile, such as \p convolution_tile_scalar.
+using ConvolutionTileFunction = void (*)(float*             output,
+                                         const std::size_t  output_stride,
+                                         const float*       input,
+                                         const std::size_t  input_stride,
+                                         const float*       mask,
+                                         const unsigned int mask_width,
+                                         const std::size_t  rows,
+                                         const std::size_t  columns);
+
+/// \brief Returns the tile convolution for \p Level and \p MaskWidth, or the scalar one if no
+/// vectorized version is available on this architecture.
+template<SimdLevel Level, unsigned int MaskWidth>
+constexpr ConvolutionTileFunction convolution_tile_function()
+{
+#ifdef CONVOLUTION_X86_SIMD
+    if constexpr(Level == SimdLevel::avx512)
+    {
+        return convolution_tile_avx512<MaskWidth>;
+    }
+    if constexpr(Level == SimdLevel::avx2)
+    {
+        return convolution_tile_avx2<MaskWidth>;
+    }
+#endif
+    return convolution_tile_scalar<MaskWidth>;
+}
+
+/// \brief Table of the tile convolutions for \p Level: the generic version followed by the
+/// specializations for the mask widths <tt>2 * i + 3</tt>.
+template<SimdLevel Level, std::size_t... Indices>
+constexpr std::array<ConvolutionTileFunction, sizeof...(Indices) + 1>
+    make_convolution_tile_table(std::index_sequence<Indices...>)
+{
+    return {convolution_tile_function<Level, 0>(),
+            convolution_tile_function<Level, 2 * Indices + 3>()...};
+}
+
+/// \brief Returns the tile convolution for \p level specialized for \p mask_width, or the
+/// generic version if there is none or \p specialized is false. \p level must be supported by
+/// the host, which can be checked with \p get_host_simd_level.
+inline ConvolutionTileFunction get_convolution_tile_function(const SimdLevel    level,
+                                                             const unsigned int mask_width,
+                                                             const bool         specialized = true)
+{
+    using Indices = std::make_index_sequence<(max_specialized_mask_width - 1) / 2>;
+    constexpr auto scalar_table = make_convolution_tile_table<SimdLevel::scalar>(Indices());
+    constexpr auto avx2_table   = make_convolution_tile_table<SimdLevel::avx2>(Indices());
+    constexpr auto avx512_table = make_convolution_tile_table<SimdLevel::avx512>(Indices());
+
+    const auto& table = level == SimdLevel::avx512 ? avx512_table
+                        : level == SimdLevel::avx2 ? avx2_table
+                                                   : scalar_table;
+    return table[specialized && is_specialized_mask_width(mask_width) ? (mask_width - 1) / 2 : 0];
+}
+
+/// \brief Returns the number of columns of the strips of \p convolution_direct_cpu for a grid
+/// of \p width columns and a mask of width \p mask_width. The \p mask_width input rows that
+/// an output row of a strip reads, and the output row itself, take up at most half of
+/// \p l2_cache_size bytes, so that each input row stays in the cache while it is reused by
+/// \p mask_width consecutive output rows.
+inline unsigned int get_convolution_strip_width(const unsigned int width,
+                                                const unsigned int mask_width,
+                                                const std::size_t  l2_cache_size
+                                                = get_host_l2_cache_size())
+{
+    // Strips are a multiple of the number of elements of a cache line.
+    constexpr std::size_t alignment = 64 / sizeof(float);
+
+    const std::size_t strip_width = l2_cache_size / 2 / ((mask_width + 1) * sizeof(float));
+    return static_cast<unsigned int>(
+        std::min<std::size_t>(width, std::max(alignment, strip_width / alignment * alignment)));
+}
+
+/// \brief Number of output rows that \p convolution_direct_cpu processes at once. The elements
+/// of these rows near the edges of the grid are computed together, from a copy of their input.
+constexpr unsigned int convolution_border_rows = 32;
+
+/// \brief Direct convolution of the rows <tt>[row_begin, row_end)</tt> of the grid of \p input
+/// with the \p mask_width x \p mask_width \p mask by \p convolution_tile, as described in
+/// \p convolution_direct_cpu. \p output points to the first of these rows, which are
+/// \p input.width elements apart. \p block is the scratch buffer of the elements near the edges.
+inline void convolution_direct_rows(float*                        output,
+                                    const ConvolutionInput&       input,
+                                    const float*                  mask,
+                                    const unsigned int            mask_width,
+                                    const ConvolutionTileFunction convolution_tile,
+                                    const std::size_t             row_begin,
+                                    const std::size_t             row_end,
+                                    std::vector<float>&           block)
+{
+    const std::size_t width       = input.width;
+    const std::size_t height      = input.height;
+    const std::size_t radius      = mask_width / 2;
+    const std::size_t halo        = input.halo_rows;
+    const std::size_t strip_width = get_convolution_strip_width(input.width, mask_width);
+
+    // Index of the input row or column that the mask of output row or column index reads first.
+    const auto first_input = [&](const std::size_t index)
+    { return static_cast<std::ptrdiff_t>(index) - static_cast<std::ptrdiff_t>(radius); };
+
+    // Output row y of the grid.
+    const auto output_row = [&](const std::size_t y) { return output + (y - row_begin) * width; };
+
+    // Rows whose input rows are all stored, and columns whose input columns are all inside of
+    // the grid.
+    const std::size_t interior_row_begin = std::min(height, radius > halo ? radius - halo : 0);
+    const std::size_t interior_row_end
+        = std::max(interior_row_begin, height + halo > radius ? height + halo - radius : 0);
+    const std::size_t interior_column_begin = std::min(width, radius);
+    const std::size_t interior_column_end
+        = std::max(interior_column_begin, width > radius ? width - radius : 0);
+
+    // Computes the output elements of rows [first_row, last_row) and columns
+    // [first_column, last_column) from a copy of the input elements that they read in block.
+    const auto convolve_border = [&](const std::size_t first_row,
+                                     const std::size_t last_row,
+                                     const std::size_t first_column,
+                                     const std::size_t last_column)
+    {
+        const std::size_t columns      = last_column - first_column;
+        const std::size_t block_stride = columns + radius * 2;
+        for(std::size_t y = first_row; y < last_row && columns != 0; y += convolution_border_rows)
+        {
+            const std::size_t rows = std::min<std::size_t>(convolution_border_rows, last_row - y);
+            block.resize((rows + radius * 2) * block_stride);
+            for(std::size_t i = 0; i < rows + radius * 2; ++i)
+            {
+                load_input_row(input,
+                               first_input(y) + static_cast<std::ptrdiff_t>(i),
+                               first_input(first_column),
+                               block_stride,
+                               block.data() + i * block_stride);
+            }
+            convolution_tile(output_row(y) + first_column,
+                             width,
+                             block.data(),
+                             block_stride,
+                             mask,
+                             mask_width,
+                             rows,
+                             columns);
+        }
+    };
+
+    convolve_border(row_begin, std::min(row_end, interior_row_begin), 0, width);
+
+    // The interior rows are processed in blocks, whose elements near the left and right edge are
+    // computed while their input rows are still in the cache.
+    for(std::size_t first_row = std::max(row_begin, interior_row_begin);
+        first_row < std::min(row_end, interior_row_end);
+        first_row += convolution_border_rows)
+    {
+        const std::size_t last_row
+            = std::min({row_end, interior_row_end, first_row + convolution_border_rows});
+        convolve_border(first_row, last_row, 0, interior_column_begin);
+
+        // The input rows of the interior are stored, so they are read in place.
+        const float* const input_row = input.row(first_input(first_row));
+        for(std::size_t column = interior_column_begin; column < interior_column_end;
+            column += strip_width)
+        {
+            convolution_tile(output_row(first_row) + column,
+                             width,
+                             input_row + column - radius,
+                             width,
+                             mask,
+                             mask_width,
+                             last_row - first_row,
+                             std::min(strip_width, interior_column_end - column));
+        }
+        convolve_border(first_row, last_row, interior_column_end, width);
+    }
+
+    convolve_border(std::max(row_begin, interior_row_end), row_end, 0, width);
+}
+
+/// \brief Multithreaded direct convolution of the grid of \p input with the
+/// \p mask_width x \p mask_width \p mask. \p output has the size of the grid.
+///
+/// The output elements whose mask lies inside of the grid (or its stored halo rows) are computed
+/// from the input directly. The remaining ones, within <tt>mask_width / 2</tt> elements of the
+/// edges, are computed in blocks of up to \p convolution_border_rows rows by the same kernels,
+/// from a small copy of the input elements that they read, in which the elements outside of the
+/// grid are derived with the boundary mode of \p input (see \p load_input_row). Hence the
+/// interior needs no padded copy of the grid and no checks for its edges.
+///
+/// The rows of \p output are split across \p num_threads host threads (by default,
+/// \p get_default_host_threads()). Each thread walks the interior of each block of its rows in
+/// vertical strips of \p get_convolution_strip_width columns, so that the input rows of a strip
+/// are read from the L2 cache by all output rows that use them, instead of from memory, and
+/// computes the elements near the left and right edge of the block right after, while their
+/// input rows are still in the cache. The tiles are computed by the vectorized kernels for
+/// \p simd_level, which is lowered to the level supported by the host if necessary, specialized
+/// for \p mask_width unless \p specialized is false. Every level adds up the terms of each
+/// element in the same order, so the results are identical to those of
+/// \p convolution_reference.
+inline void convolution_direct_cpu(float*                  output,
+                                   const ConvolutionInput& input,
+                                   const float*            mask,
+                                   const unsigned int      mask_width,
+                                   const unsigned int      num_threads = 0,
+                                   const SimdLevel         simd_level  = get_host_simd_level(),
+                                   const bool              specialized = true)
+{
+    const ConvolutionTileFunction convolution_tile
+        = get_convolution_tile_function(std::min(simd_level, get_host_simd_level()),
+                                        mask_width,
+                                        specialized);
+    parallel_for(input.height,
+                 1,
+                 num_threads,
+                 [&](const std::size_t row_begin, const std::size_t row_end)
+                 {
+                     std::vector<float> block;
+                     convolution_direct_rows(output + row_begin * input.width,
+                                             input,
+                                             mask,
+                                             mask_width,
+                                             convolution_tile,
+                                             row_begin,
+                                             row_end,
+                                             block);
+                 });
+}
+
+#endif // _APPLICATIONS_CONVOLUTION_CONVOLUTION_CPU_HPP
@@ -0,0 +1,454 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_CONVOLUTION_CONVOLUTION_FFT_HPP
+#define _APPLICATIONS_CONVOLUTION_CONVOLUTION_FFT_HPP
+
+#include "convolution_boundary.hpp"
+#include "convolution_cpu.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+/// \brief Precomputed bit reversal permutation and twiddle factors of the radix-2 fast Fourier
+/// transform of sequences of \p size complex elements, where \p size is a power of two.
+class FftPlan
+{
+public:
+    explicit FftPlan(const std::size_t size)
+        : size(size), bit_reversal(size), twiddles_real(size / 2), twiddles_imag(size / 2)
+    {
+        unsigned int bits = 0;
+        while((std::size_t{1} << bits) < size)
+        {
+            ++bits;
+        }
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            std::size_t reversed = 0;
+            for(unsigned int bit = 0; bit < bits; ++bit)
+            {
+                reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+            }
+            bit_reversal[i] = reversed;
+        }
+        const double pi = std::acos(-1.0);
+        for(std::size_t i = 0; i < size / 2; ++i)
+        {
+            const double angle = -2.0 * pi * static_cast<double>(i) / static_cast<double>(size);
+            twiddles_real[i]   = static_cast<float>(std::cos(angle));
+            twiddles_imag[i]   = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    std::size_t get_size() const
+    {
+        return size;
+    }
+
+    /// \brief Transforms every column of the \p size x \p columns matrix whose real and
+    /// imaginary parts are stored row-major in \p real and \p imag, in place. The inverse
+    /// transform is not scaled by <tt>1 / size</tt>.
+    ///
+    /// The butterflies combine whole rows, so the innermost loops run along consecutive elements
+    /// of all columns at once and can be vectorized, and rows are transformed by transposing the
+    /// matrix first.
+    void transform_columns(float*            real,
+                           float*            imag,
+                           const std::size_t columns,
+                           const bool        inverse) const
+    {
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            const std::size_t j = bit_reversal[i];
+            if(i < j)
+            {
+                std::swap_ranges(real + i * columns, real + (i + 1) * columns, real + j * columns);
+                std::swap_ranges(imag + i * columns, imag + (i + 1) * columns, imag + j * columns);
+            }
+        }
+        for(std::size_t length = 2; length <= size; length *= 2)
+        {
+            const std::size_t half   = length / 2;
+            const std::size_t stride = size / length;
+            for(std::size_t begin = 0; begin < size; begin += length)
+            {
+                for(std::size_t j = 0; j < half; ++j)
+                {
+                    const float w_real = twiddles_real[j * stride];
+                    const float w_imag
+                        = inverse ? -twiddles_imag[j * stride] : twiddles_imag[j * stride];
+
+                    float* const a_real = real + (begin + j) * columns;
+                    float* const a_imag = imag + (begin + j) * columns;
+                    float* const b_real = real + (begin + j + half) * columns;
+                    float* const b_imag = imag + (begin + j + half) * columns;
+                    for(std::size_t x = 0; x < columns; ++x)
+                    {
+                        const float t_real = b_real[x] * w_real - b_imag[x] * w_imag;
+                        const float t_imag = b_real[x] * w_imag + b_imag[x] * w_real;
+                        b_real[x]          = a_real[x] - t_real;
+                        b_imag[x]          = a_imag[x] - t_imag;
+                        a_real[x] += t_real;
+                        a_imag[x] += t_imag;
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    std::size_t              size;
+    std::vector<std::size_t> bit_reversal;
+    std::vector<float>       twiddles_real;
+    std::vector<float>       twiddles_imag;
+};
+
+/// \brief Transposes the \p size x \p size matrix \p data in place, in blocks that fit in the
+/// L1 cache.
+inline void transpose_square(float* data, const std::size_t size)
+{
+    constexpr std::size_t block = 16;
+    for(std::size_t y_block = 0; y_block < size; y_block += block)
+    {
+        for(std::size_t x_block = y_block; x_block < size; x_block += block)
+        {
+            for(std::size_t y = y_block; y < std::min(y_block + block, size); ++y)
+            {
+                for(std::size_t x = std::max(x_block, y + 1); x < std::min(x_block + block, size);
+                    ++x)
+                {
+                    std::swap(data[y * size + x], data[x * size + y]);
+                }
+            }
+        }
+    }
+}
+
+/// \brief Computes the two-dimensional transform of the \p size x \p size matrix whose real
+/// and imaginary parts are \p real and \p imag with \p plan. The forward transform of a matrix
+/// in the natural order results in the transposed transform, and the inverse transform of a
+/// transposed transform in the natural order.
+inline void transform_square(const FftPlan& plan, float* real, float* imag, const bool inverse)
+{
+    const std::size_t size = plan.get_size();
+    plan.transform_columns(real, imag, size, inverse);
+    transpose_square(real, size);
+    transpose_square(imag, size);
+    plan.transform_columns(real, imag, size, inverse);
+}
+
+/// \brief Returns the size of the square FFTs of \p convolution_fft_cpu for a \p width x
+/// \p height grid and a mask of width \p mask_width: the power of two that minimizes the
+/// transform work per output element, <tt>size^2 * log2(size) / (size - mask_width + 1)^2</tt>.
+/// It is at least <tt>2 * (mask_width - 1)</tt>, so that only the tiles of adjacent tile rows
+/// overlap, and at most \p max_size or the smallest power of two that holds the whole grid.
+inline std::size_t get_fft_size(const unsigned int width,
+                                const unsigned int height,
+                                const unsigned int mask_width,
+                                const std::size_t  max_size = 512)
+{
+    std::size_t min_size = 2;
+    while(min_size < 2 * static_cast<std::size_t>(mask_width - 1))
+    {
+        min_size *= 2;
+    }
+    std::size_t grid_size = 2;
+    while(grid_size < std::max(width, height) + static_cast<std::size_t>(mask_width - 1))
+    {
+        grid_size *= 2;
+    }
+
+    std::size_t best_size = min_size;
+    double      best_cost = std::numeric_limits<double>::max();
+    for(std::size_t size = min_size; size <= std::max(min_size, std::min(max_size, grid_size));
+        size *= 2)
+    {
+        const double tile = static_cast<double>(size - mask_width + 1);
+        const double cost = static_cast<double>(size * size) * std::log2(size) / (tile * tile);
+        if(cost < best_cost)
+        {
+            best_size = size;
+            best_cost = cost;
+        }
+    }
+    return best_size;
+}
+
+/// \brief Multithreaded FFT convolution of the grid of \p input with the
+/// \p mask_width x \p mask_width \p mask, with the overlap-add method. \p output has the size
+/// of the grid.
+///
+/// The grid, extended by <tt>mask_width / 2</tt> elements on every side, is split into tiles of
+/// <tt>fft_size - mask_width + 1</tt> square elements (see \p get_fft_size). The tiles are loaded
+/// with \p load_input_row, so the extension holds the elements that the boundary mode of \p input
+/// derives, or the halo rows of a band. The full linear convolution of each tile with the mask has
+/// <tt>fft_size</tt> square elements, so it is computed exactly by the cyclic convolution of
+/// transforms of that size, which is the product of the transforms of the tile and the (flipped)
+/// mask. These results overlap by <tt>mask_width - 1</tt> elements and are added up into \p output.
+/// Two horizontally adjacent tiles share a transform as its real and imaginary part: as the mask is
+/// real, the real and the imaginary part of the result are their convolutions. The transforms are
+/// computed with \p transform_square, whose forward transform is transposed, and the mask is
+/// transformed the same way, so the product is computed in the transposed order.
+///
+/// Tile rows are split across \p num_threads host threads (by default,
+/// \p get_default_host_threads()), first the even and then the odd ones, because the results of
+/// adjacent tile rows overlap. Besides the output, each thread only needs one transform buffer,
+/// so the memory use is bounded regardless of the size of the grid. The results differ from
+/// those of the direct algorithm by rounding errors.
+inline void convolution_fft_cpu(float*                  output,
+                                const ConvolutionInput& input,
+                                const float*            mask,
+                                const unsigned int      mask_width,
+                                const unsigned int      num_threads = 0)
+{
+    const unsigned int   width         = input.width;
+    const unsigned int   height        = input.height;
+    const std::ptrdiff_t radius        = mask_width / 2;
+    const unsigned int   padded_width  = width + (mask_width / 2) * 2;
+    const unsigned int   padded_height = height + (mask_width / 2) * 2;
+    const std::size_t    fft_size      = get_fft_size(padded_width, padded_height, mask_width);
+    const std::size_t    tile_size     = fft_size - mask_width + 1;
+    // Element (y, x) of the output is element (y + offset, x + offset) of the full convolution
+    // of the extended grid.
+    const std::size_t offset    = mask_width - 1;
+    const std::size_t tile_rows = ceiling_div(padded_height, tile_size);
+    const std::size_t tile_cols = ceiling_div(padded_width, tile_size);
+    const float       scale     = 1.0f / static_cast<float>(fft_size * fft_size);
+    const FftPlan     plan(fft_size);
+
+    // Transposed transform of the mask, flipped to turn the correlation of the direct algorithm
+    // into a convolution.
+    std::vector<float> mask_real(fft_size * fft_size), mask_imag(fft_size * fft_size);
+    for(unsigned int y = 0; y < mask_width; ++y)
+    {
+        for(unsigned int x = 0; x < mask_width; ++x)
+        {
+            mask_real[y * fft_size + x]
+                = mask[(mask_width - 1 - y) * mask_width + (mask_width - 1 - x)];
+        }
+    }
+    transform_square(plan, mask_real.data(), mask_imag.data(), false);
+
+    parallel_for(height,
+                 1,
+                 num_threads,
+                 [&](const std::size_t row_begin, const std::size_t row_end)
+                 { std::fill(output + row_begin * width, output + row_end * width, 0.0f); });
+
+    const auto process_tile_rows = [&](const std::size_t parity,
+                                       const std::size_t item_begin,
+                                       const std::size_t item_end)
+    {
+        std::vector<float> real(fft_size * fft_size), imag(fft_size * fft_size);
+        for(std::size_t item = item_begin; item < item_end; ++item)
+        {
+            const std::size_t tile_row = 2 * item + parity;
+            const std::size_t y_begin  = tile_row * tile_size;
+            const std::size_t rows     = std::min<std::size_t>(tile_size, padded_height - y_begin);
+
+            // Rows of the result that fall into the output.
+            const std::size_t result_begin = y_begin < offset ? offset - y_begin : 0;
+            const std::size_t result_end   = std::min(fft_size, height + offset - y_begin);
+
+            for(std::size_t tile_col = 0; tile_col < tile_cols; tile_col += 2)
+            {
+                const std::size_t x_begin[2] = {tile_col * tile_size, (tile_col + 1) * tile_size};
+                const std::size_t cols[2]
+                    = {std::min<std::size_t>(tile_size, padded_width - x_begin[0]),
+                       tile_col + 1 < tile_cols
+                           ? std::min<std::size_t>(tile_size, padded_width - x_begin[1])
+                           : 0};
+
+                // Load the pair of tiles as the real and the imaginary part.
+                std::fill(real.begin(), real.end(), 0.0f);
+                std::fill(imag.begin(), imag.end(), 0.0f);
+                for(std::size_t y = 0; y < rows; ++y)
+                {
+                    const std::ptrdiff_t input_y
+                        = static_cast<std::ptrdiff_t>(y_begin + y) - radius;
+                    for(unsigned int part = 0; part < 2 && cols[part] != 0; ++part)
+                    {
+                        load_input_row(input,
+                                       input_y,
+                                       static_cast<std::ptrdiff_t>(x_begin[part]) - radius,
+                                       cols[part],
+                                       (part == 0 ? real.data() : imag.data()) + y * fft_size);
+                    }
+                }
+
+                // Multiply the transforms and transform the product back.
+                transform_square(plan, real.data(), imag.data(), false);
+                for(std::size_t i = 0; i < fft_size * fft_size; ++i)
+                {
+                    const float a_real = real[i];
+                    const float a_imag = imag[i];
+                    real[i]            = a_real * mask_real[i] - a_imag * mask_imag[i];
+                    imag[i]            = a_real * mask_imag[i] + a_imag * mask_real[i];
+                }
+                transform_square(plan, real.data(), imag.data(), true);
+
+                // Add the rows of the result that fall into the output.
+                for(std::size_t y = result_begin; y < result_end; ++y)
+                {
+                    float* const output_row = output + (y_begin + y - offset) * width;
+                    for(unsigned int part = 0; part < 2 && cols[part] != 0; ++part)
+                    {
+                        const float* const result_row
+                            = (part == 0 ? real.data() : imag.data()) + y * fft_size;
+                        // Columns of the result that fall into the output.
+                        const std::size_t x_first
+                            = x_begin[part] < offset ? offset - x_begin[part] : 0;
+                        const std::size_t x_last
+                            = std::min(fft_size, width + offset - x_begin[part]);
+                        for(std::size_t x = x_first; x < x_last; ++x)
+                        {
+                            output_row[x_begin[part] + x - offset] += result_row[x] * scale;
+                        }
+                    }
+                }
+            }
+        }
+    };
+    for(const std::size_t parity : {0, 1})
+    {
+        parallel_for((tile_rows + 1 - parity) / 2,
+                     1,
+                     num_threads,
+                     [&](const std::size_t item_begin, const std::size_t item_end)
+                     { process_tile_rows(parity, item_begin, item_end); });
+    }
+}
+
+/// \brief Entry of a crossover table between the direct and the FFT algorithm: for grids of at
+/// most \p max_pixels elements, the FFT algorithm is faster for masks of width \p mask_width and
+/// wider.
+struct FftCrossover
+{
+    std::size_t  max_pixels;
+    unsigned int mask_width;
+};
+
+/// \brief Returns the crossover table used when none is measured. It was measured with
+/// \p measure_fft_crossover on a single core of an AVX-512 capable server CPU, so it should be
+/// measured again for other hosts.
+inline std::vector<FftCrossover> get_default_fft_crossover_table()
+{
+    return {{256 * 256, 53},
+            {1024 * 1024, 27},
+            {std::numeric_limits<std::size_t>::max(), 19}};
+}
+
+/// \brief Returns whether \p table predicts that the FFT algorithm is faster than the direct one
+/// for a grid of \p pixels elements and a mask of width \p mask_width.
+inline bool fft_is_faster(const std::vector<FftCrossover>& table,
+                          const std::size_t                pixels,
+                          const unsigned int               mask_width)
+{
+    for(const FftCrossover& entry : table)
+    {
+        if(pixels <= entry.max_pixels)
+        {
+            return mask_width >= entry.mask_width;
+        }
+    }
+    return false;
+}
+
+/// \brief Measures a crossover table between \p convolution_direct_cpu with \p simd_level and
+/// \p convolution_fft_cpu with \p num_threads threads. For random square grids of each of the
+/// \p grid_sides, the odd mask widths from 3 to \p max_mask_width are benchmarked until the FFT
+/// algorithm is faster at the median time. The entry of each grid side applies to grids of up to
+/// twice that side squared, the last one to all larger grids. If the FFT algorithm is never
+/// faster, the crossover is <tt>max_mask_width + 1</tt>.
+inline std::vector<FftCrossover>
+    measure_fft_crossover(const unsigned int               num_threads,
+                          const SimdLevel                  simd_level,
+                          const std::vector<unsigned int>& grid_sides     = {128, 512, 2048},
+                          const unsigned int               max_mask_width = 63)
+{
+    BenchmarkSettings settings;
+    settings.warmup_trials = 1;
+    settings.min_trials    = 3;
+    settings.max_time      = 1.0;
+
+    std::mt19937                          random_engine{0};
+    std::uniform_real_distribution<float> distribution{-1.0f, 1.0f};
+
+    std::vector<FftCrossover> table;
+    for(std::size_t i = 0; i < grid_sides.size(); ++i)
+    {
+        const unsigned int side = grid_sides[i];
+        FftCrossover       entry{i + 1 < grid_sides.size()
+                                     ? std::size_t{2} * side * 2 * side
+                                     : std::numeric_limits<std::size_t>::max(),
+                           max_mask_width + 1};
+        std::vector<float> output(std::size_t{side} * side);
+        for(unsigned int mask_width = 3; mask_width <= max_mask_width; mask_width += 2)
+        {
+            std::vector<float> grid(std::size_t{side} * side);
+            std::vector<float> mask(mask_width * mask_width);
+            std::generate(grid.begin(), grid.end(), [&] { return distribution(random_engine); });
+            std::generate(mask.begin(), mask.end(), [&] { return distribution(random_engine); });
+            const ConvolutionInput input{grid.data(), side, side};
+
+            const double direct_median = run_host_benchmark(
+                                             [&]
+                                             {
+                                                 convolution_direct_cpu(output.data(),
+                                                                        input,
+                                                                        mask.data(),
+                                                                        mask_width,
+                                                                        num_threads,
+                                                                        simd_level);
+                                             },
+                                             settings)
+                                             .median;
+            const double fft_median = run_host_benchmark(
+                                          [&]
+                                          {
+                                              convolution_fft_cpu(output.data(),
+                                                                  input,
+                                                                  mask.data(),
+                                                                  mask_width,
+                                                                  num_threads);
+                                          },
+                                          settings)
+                                          .median;
+            if(fft_median < direct_median)
+            {
+                entry.mask_width = mask_width;
+                break;
+            }
+        }
+        table.push_back(entry);
+    }
+    return table;
+}
+
+#endif // _APPLICATIONS_CONVOLUTION_CONVOLUTION_FFT_HPP
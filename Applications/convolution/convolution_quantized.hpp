@@ -0,0 +1,629 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_CONVOLUTION_CONVOLUTION_QUANTIZED_HPP
+#define _APPLICATIONS_CONVOLUTION_CONVOLUTION_QUANTIZED_HPP
+
+#include "convolution_boundary.hpp"
+#include "convolution_simd.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+/// \brief Fixed-point formats of the mask of the quantized convolution.
+enum class QuantizedMaskFormat
+{
+    /// 8-bit weights, whose magnitude is limited to \p quantized_int8_weight_limit, multiplied
+    /// with the input elements by pairs with <tt>maddubs</tt> instructions.
+    int8,
+    /// 16-bit weights, multiplied with the input elements widened to 16 bits by pairs with
+    /// <tt>madd</tt> instructions.
+    int16
+};
+
+/// \brief Returns the name of a \p QuantizedMaskFormat, as accepted by
+/// \p parse_quantized_mask_format.
+inline const char* quantized_mask_format_name(const QuantizedMaskFormat format)
+{
+    return format == QuantizedMaskFormat::int8 ? "int8" : "int16";
+}
+
+/// \brief Parses the \p name of a fixed-point mask format into \p format. Returns false if the
+/// name is unknown.
+inline bool parse_quantized_mask_format(const std::string& name, QuantizedMaskFormat& format)
+{
+    for(const QuantizedMaskFormat candidate :
+        {QuantizedMaskFormat::int8, QuantizedMaskFormat::int16})
+    {
+        if(name == quantized_mask_format_name(candidate))
+        {
+            format = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// \brief Largest magnitude of the 8-bit weights. \p _mm256_maddubs_epi16 adds the products of
+/// two unsigned input elements and two signed weights with signed 16-bit saturation, which
+/// never saturates if the two weights add up to at most 128 in magnitude, as
+/// <tt>255 * 128 <= 32767</tt>.
+constexpr int quantized_int8_weight_limit = 64;
+
+/// \brief Largest number of fractional bits of the fixed-point weights.
+constexpr unsigned int quantized_max_shift = 16;
+
+/// \brief Mask of \p width x \p width fixed-point weights with \p shift fractional bits: weight
+/// w stands for <tt>w / 2^shift</tt>.
+struct QuantizedMask
+{
+    std::vector<std::int16_t> weights;
+    unsigned int              width  = 0;
+    unsigned int              shift  = 0;
+    QuantizedMaskFormat       format = QuantizedMaskFormat::int16;
+};
+
+/// \brief Converts the \p mask_width x \p mask_width \p mask to fixed-point weights of
+/// \p format with as many fractional bits as possible, such that the weights fit the format and
+/// that no sum of products of 8-bit input elements and weights, including the rounding term of
+/// \p requantize, exceeds 32 bits.
+inline QuantizedMask quantize_mask(const float*              mask,
+                                   const unsigned int        mask_width,
+                                   const QuantizedMaskFormat format)
+{
+    const std::size_t mask_size = static_cast<std::size_t>(mask_width) * mask_width;
+    const double      limit     = format == QuantizedMaskFormat::int8
+                                      ? quantized_int8_weight_limit
+                                      : std::numeric_limits<std::int16_t>::max();
+
+    QuantizedMask quantized;
+    quantized.width  = mask_width;
+    quantized.format = format;
+    quantized.weights.resize(mask_size);
+    for(unsigned int shift = quantized_max_shift + 1; shift-- > 0;)
+    {
+        const double scale = std::ldexp(1.0, shift);
+        double       sum   = 0;
+        bool         fits  = true;
+        for(std::size_t i = 0; i < mask_size && fits; ++i)
+        {
+            const double weight = std::nearbyint(mask[i] * scale);
+            fits                = std::abs(weight) <= limit;
+            sum += std::abs(weight);
+        }
+        if(fits && 255 * sum + scale / 2 <= std::numeric_limits<std::int32_t>::max())
+        {
+            for(std::size_t i = 0; i < mask_size; ++i)
+            {
+                quantized.weights[i] = static_cast<std::int16_t>(std::nearbyint(mask[i] * scale));
+            }
+            quantized.shift = shift;
+            return quantized;
+        }
+    }
+
+    // Even integer weights do not fit, saturate them.
+    for(std::size_t i = 0; i < mask_size; ++i)
+    {
+        quantized.weights[i]
+            = static_cast<std::int16_t>(std::clamp<double>(std::nearbyint(mask[i]), -limit, limit));
+    }
+    return quantized;
+}
+
+/// \brief Returns the largest difference between the weights of \p mask and the \p quantized
+/// weights that stand for them.
+inline double quantization_error(const float* mask, const QuantizedMask& quantized)
+{
+    double error = 0;
+    for(std::size_t i = 0; i < quantized.weights.size(); ++i)
+    {
+        const double weight = std::ldexp(quantized.weights[i], -static_cast<int>(quantized.shift));
+        error               = std::max(error, std::abs(weight - mask[i]));
+    }
+    return error;
+}
+
+/// \brief Converts the 32-bit sum of products \p sum of 8-bit input elements and weights with
+/// \p shift fractional bits to an 8-bit output element: the sum is rounded to the nearest
+/// integer, halves upwards, and saturated to [0, 255].
+inline std::uint8_t requantize(const std::int32_t sum, const unsigned int shift)
+{
+    const std::int32_t rounding = shift == 0 ? 0 : std::int32_t{1} << (shift - 1);
+    const std::int32_t value    = (sum + rounding) >> shift;
+    return static_cast<std::uint8_t>(std::clamp<std::int32_t>(value, 0, 255));
+}
+
+/// \brief Weights of a \p QuantizedMask arranged for the quantized kernels: every row of the
+/// mask is split into groups of four 8-bit or pairs of 16-bit weights, padded with zeros, each
+/// of which is packed into a 32-bit element, so that the kernels broadcast it into a vector.
+struct QuantizedKernelWeights
+{
+    const QuantizedMask*      mask = nullptr;
+    std::vector<std::int32_t> packed;
+    unsigned int              group_size = 0;
+    unsigned int              groups     = 0;
+
+    explicit QuantizedKernelWeights(const QuantizedMask& quantized) : mask(&quantized)
+    {
+        group_size = quantized.format == QuantizedMaskFormat::int8 ? 4 : 2;
+        groups     = (quantized.width + group_size - 1) / group_size;
+        packed.resize(static_cast<std::size_t>(quantized.width) * groups);
+        const unsigned int bits = 32 / group_size;
+        for(unsigned int y = 0; y < quantized.width; ++y)
+        {
+            for(unsigned int g = 0; g < groups; ++g)
+            {
+                std::uint32_t group = 0;
+                for(unsigned int i = 0; i < group_size; ++i)
+                {
+                    const unsigned int x      = g * group_size + i;
+                    const std::int16_t weight = x < quantized.width
+                                                    ? quantized.weights[y * quantized.width + x]
+                                                    : 0;
+                    group |= (static_cast<std::uint32_t>(weight) & ((1u << bits) - 1))
+                             << (i * bits);
+                }
+                packed[y * groups + g] = static_cast<std::int32_t>(group);
+            }
+        }
+    }
+};
+
+/// \brief Number of elements of the expanded rows of the quantized kernels beyond those that the
+/// mask covers, which the vectorized kernels read with zero weights when the mask width is not
+/// a multiple of the group size.
+constexpr unsigned int quantized_row_padding = 3;
+
+/// \brief Expands \p count elements of the row of 8-bit elements \p source, which must hold
+/// three more, for the kernels of \p format: element x of \p destination holds the four input
+/// elements from x on for 8-bit weights, and the two input elements from x on widened to 16 bits
+/// for 16-bit weights, in order from the least significant bits on. So the input elements that
+/// a group of weights is multiplied with are a single 32-bit element, and the vectors of these
+/// for consecutive output elements are loaded directly, without rearranging elements, at every
+/// offset of a group. Each input row is expanded once for the \p mask_width output rows that
+/// read it. The lowest bits of every element are the input element itself.
+inline void expand_quantized_row(const std::uint8_t*       source,
+                                 const std::size_t         count,
+                                 const QuantizedMaskFormat format,
+                                 std::uint32_t*            destination)
+{
+    if(format == QuantizedMaskFormat::int8)
+    {
+        for(std::size_t x = 0; x < count; ++x)
+        {
+            destination[x] = source[x] | source[x + 1] << 8 | source[x + 2] << 16
+                             | static_cast<std::uint32_t>(source[x + 3]) << 24;
+        }
+    }
+    else
+    {
+        for(std::size_t x = 0; x < count; ++x)
+        {
+            destination[x] = source[x] | source[x + 1] << 16;
+        }
+    }
+}
+
+/// \brief Computes output elements [\p begin, \p end) of \p convolution_quantized_row_scalar.
+inline void convolution_quantized_elements(std::uint8_t*                 output,
+                                           const std::uint32_t* const*   rows,
+                                           const QuantizedKernelWeights& weights,
+                                           const std::size_t             begin,
+                                           const std::size_t             end)
+{
+    const QuantizedMask& mask    = *weights.mask;
+    const std::uint32_t  element = mask.format == QuantizedMaskFormat::int8 ? 0xFF : 0xFFFF;
+    for(std::size_t x = begin; x < end; ++x)
+    {
+        std::int32_t sum = 0;
+        for(unsigned int i = 0; i < mask.width; ++i)
+        {
+            for(unsigned int j = 0; j < mask.width; ++j)
+            {
+                const std::int32_t input = rows[i][x + j] & element;
+                sum += input * mask.weights[i * mask.width + j];
+            }
+        }
+        output[x] = requantize(sum, mask.shift);
+    }
+}
+
+/// \brief Quantized convolution of a row of \p columns output elements with the mask of
+/// \p weights. Output element x, which is stored to <tt>output[x]</tt>, is the requantized sum
+/// of the products of the weights <tt>(i, j)</tt> and the input elements <tt>(i, x + j)</tt> of
+/// the \p rows expanded with \p expand_quantized_row, so the rows start at the input element
+/// <tt>mask_width / 2</tt> left of the first output element. Every row must hold
+/// <tt>columns + mask_width - 1 + quantized_row_padding</tt> elements. The products are summed
+/// up exactly in 32 bits, so every version computes the same results.
+inline void convolution_quantized_row_scalar(std::uint8_t*                 output,
+                                             const std::uint32_t* const*   rows,
+                                             const QuantizedKernelWeights& weights,
+                                             const std::size_t             columns)
+{
+    convolution_quantized_elements(output, rows, weights, 0, columns);
+}
+
+#ifdef CONVOLUTION_X86_SIMD
+/// \brief Returns whether the host CPU supports the AVX-512 byte and word instructions, which the
+/// AVX-512 quantized kernels use in addition to the foundation instructions.
+inline bool host_supports_avx512bw()
+{
+    #if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return get_host_simd_level() == SimdLevel::avx512 && (info[1] & (1 << 30)) != 0;
+    #else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512bw");
+    #endif
+}
+
+/// \brief AVX2 version of \p expand_quantized_row for \p Format. For 8-bit weights, the low
+/// 128-bit lane is loaded from element x on and the high lane from element x + 4 on, and each
+/// lane is shuffled into the four groups of four elements from its first one on. For 16-bit
+/// weights, the elements from x on and from x + 1 on are widened and interleaved.
+template<QuantizedMaskFormat Format>
+CONVOLUTION_TARGET("avx2")
+void expand_quantized_row_avx2(const std::uint8_t* source,
+                               const std::size_t   count,
+                               std::uint32_t*      destination)
+{
+    std::size_t x = 0;
+    if constexpr(Format == QuantizedMaskFormat::int8)
+    {
+        const __m256i pattern = _mm256_setr_epi8(0, 1, 2, 3, 1, 2, 3, 4, 2, 3, 4, 5, 3, 4, 5, 6,
+                                                 0, 1, 2, 3, 1, 2, 3, 4, 2, 3, 4, 5, 3, 4, 5, 6);
+        // Reads the 20 elements from x on.
+        for(; x + 20 <= count + 3; x += 8)
+        {
+            const __m128i low  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x));
+            const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x + 4));
+            const __m256i elements
+                = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + x),
+                                _mm256_shuffle_epi8(elements, pattern));
+        }
+    }
+    else
+    {
+        for(; x + 16 <= count; x += 16)
+        {
+            const __m256i first  = _mm256_cvtepu8_epi16(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x)));
+            const __m256i second = _mm256_cvtepu8_epi16(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x + 1)));
+            // The pairs of elements 0-3 and 8-11, and of 4-7 and 12-15.
+            const __m256i low  = _mm256_unpacklo_epi16(first, second);
+            const __m256i high = _mm256_unpackhi_epi16(first, second);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + x),
+                                _mm256_permute2x128_si256(low, high, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + x + 8),
+                                _mm256_permute2x128_si256(low, high, 0x31));
+        }
+    }
+    expand_quantized_row(source + x, count - x, Format, destination + x);
+}
+
+/// \brief AVX2 version of \p convolution_quantized_row_scalar for the weights of \p Format,
+/// which computes four vectors of 8 consecutive output elements at once. Every group of weights
+/// is broadcast and multiplied with the vectors of expanded input elements at its offset: 8-bit
+/// weights with \p _mm256_maddubs_epi16, whose 16-bit sums of pairs are added up to 32 bits by
+/// \p _mm256_madd_epi16 with ones, 16-bit weights with \p _mm256_madd_epi16 directly. The sums
+/// are requantized by saturating packs, which interleave the vectors, and reordered by a
+/// permutation.
+template<QuantizedMaskFormat Format>
+CONVOLUTION_TARGET("avx2")
+void convolution_quantized_row_avx2(std::uint8_t*                 output,
+                                    const std::uint32_t* const*   rows,
+                                    const QuantizedKernelWeights& weights,
+                                    const std::size_t             columns)
+{
+    constexpr std::size_t vector_size = 8;
+    constexpr std::size_t block_size  = 4 * vector_size;
+
+    const QuantizedMask& mask  = *weights.mask;
+    const __m256i        ones  = _mm256_set1_epi16(1);
+    const __m128i        shift = _mm_cvtsi32_si128(mask.shift);
+    const __m256i rounding     = _mm256_set1_epi32(mask.shift == 0 ? 0 : 1 << (mask.shift - 1));
+    const __m256i order        = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    std::size_t x = 0;
+    for(; x + block_size <= columns; x += block_size)
+    {
+        __m256i sums[4] = {rounding, rounding, rounding, rounding};
+        for(unsigned int i = 0; i < mask.width; ++i)
+        {
+            for(unsigned int g = 0; g < weights.groups; ++g)
+            {
+                const __m256i group = _mm256_set1_epi32(weights.packed[i * weights.groups + g]);
+                const std::uint32_t* const input = rows[i] + x + g * weights.group_size;
+                for(unsigned int v = 0; v < 4; ++v)
+                {
+                    const __m256i elements = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(input + v * vector_size));
+                    const __m256i products
+                        = Format == QuantizedMaskFormat::int8
+                              ? _mm256_madd_epi16(_mm256_maddubs_epi16(elements, group), ones)
+                              : _mm256_madd_epi16(elements, group);
+                    sums[v] = _mm256_add_epi32(sums[v], products);
+                }
+            }
+        }
+        const __m256i low  = _mm256_packs_epi32(_mm256_sra_epi32(sums[0], shift),
+                                               _mm256_sra_epi32(sums[1], shift));
+        const __m256i high = _mm256_packs_epi32(_mm256_sra_epi32(sums[2], shift),
+                                                _mm256_sra_epi32(sums[3], shift));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(output + x),
+            _mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), order));
+    }
+    convolution_quantized_elements(output, rows, weights, x, columns);
+}
+
+/// \brief AVX-512 version of \p expand_quantized_row_avx2, whose 128-bit lanes are loaded from
+/// elements x, x + 4, x + 8 and x + 12 on for 8-bit weights.
+template<QuantizedMaskFormat Format>
+CONVOLUTION_TARGET("avx512f,avx512bw")
+void expand_quantized_row_avx512(const std::uint8_t* source,
+                                 const std::size_t   count,
+                                 std::uint32_t*      destination)
+{
+    std::size_t x = 0;
+    if constexpr(Format == QuantizedMaskFormat::int8)
+    {
+        const __m512i pattern = _mm512_set4_epi32(0x06050403, 0x05040302, 0x04030201, 0x03020100);
+        // Reads the 28 elements from x on.
+        for(; x + 28 <= count + 3; x += 16)
+        {
+            const auto load = [&](const std::size_t offset)
+            { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x + offset)); };
+            __m512i elements = _mm512_castsi128_si512(load(0));
+            elements         = _mm512_inserti32x4(elements, load(4), 1);
+            elements         = _mm512_inserti32x4(elements, load(8), 2);
+            elements         = _mm512_inserti32x4(elements, load(12), 3);
+            _mm512_storeu_si512(destination + x, _mm512_shuffle_epi8(elements, pattern));
+        }
+    }
+    else
+    {
+        // Selects the pairs of elements 0-7 and 8-15 from the interleaved 128-bit lanes.
+        const __m512i first_order  = _mm512_setr_epi64(0, 1, 8, 9, 2, 3, 10, 11);
+        const __m512i second_order = _mm512_setr_epi64(4, 5, 12, 13, 6, 7, 14, 15);
+        for(; x + 32 <= count; x += 32)
+        {
+            const __m512i first  = _mm512_cvtepu8_epi16(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + x)));
+            const __m512i second = _mm512_cvtepu8_epi16(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + x + 1)));
+            const __m512i low    = _mm512_unpacklo_epi16(first, second);
+            const __m512i high   = _mm512_unpackhi_epi16(first, second);
+            _mm512_storeu_si512(destination + x,
+                                _mm512_permutex2var_epi64(low, first_order, high));
+            _mm512_storeu_si512(destination + x + 16,
+                                _mm512_permutex2var_epi64(low, second_order, high));
+        }
+    }
+    expand_quantized_row(source + x, count - x, Format, destination + x);
+}
+
+/// \brief AVX-512 version of \p convolution_quantized_row_avx2, which computes four vectors of
+/// 16 consecutive output elements at once.
+template<QuantizedMaskFormat Format>
+CONVOLUTION_TARGET("avx512f,avx512bw")
+void convolution_quantized_row_avx512(std::uint8_t*                 output,
+                                      const std::uint32_t* const*   rows,
+                                      const QuantizedKernelWeights& weights,
+                                      const std::size_t             columns)
+{
+    constexpr std::size_t vector_size = 16;
+    constexpr std::size_t block_size  = 4 * vector_size;
+
+    const QuantizedMask& mask  = *weights.mask;
+    const __m512i        ones  = _mm512_set1_epi16(1);
+    const __m512i        shift = _mm512_set1_epi32(mask.shift);
+    const __m512i rounding     = _mm512_set1_epi32(mask.shift == 0 ? 0 : 1 << (mask.shift - 1));
+    const __m512i order
+        = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+
+    std::size_t x = 0;
+    for(; x + block_size <= columns; x += block_size)
+    {
+        __m512i sums[4] = {rounding, rounding, rounding, rounding};
+        for(unsigned int i = 0; i < mask.width; ++i)
+        {
+            for(unsigned int g = 0; g < weights.groups; ++g)
+            {
+                const __m512i group = _mm512_set1_epi32(weights.packed[i * weights.groups + g]);
+                const std::uint32_t* const input = rows[i] + x + g * weights.group_size;
+                for(unsigned int v = 0; v < 4; ++v)
+                {
+                    const __m512i elements = _mm512_loadu_si512(input + v * vector_size);
+                    const __m512i products
+                        = Format == QuantizedMaskFormat::int8
+                              ? _mm512_madd_epi16(_mm512_maddubs_epi16(elements, group), ones)
+                              : _mm512_madd_epi16(elements, group);
+                    sums[v] = _mm512_add_epi32(sums[v], products);
+                }
+            }
+        }
+        // The zero-masking forms with all elements active avoid spurious warnings of GCC about
+        // the undefined source of the unmasked forms.
+        for(unsigned int v = 0; v < 4; ++v)
+        {
+            sums[v] = _mm512_maskz_srav_epi32(0xFFFF, sums[v], shift);
+        }
+        const __m512i low  = _mm512_packs_epi32(sums[0], sums[1]);
+        const __m512i high = _mm512_packs_epi32(sums[2], sums[3]);
+        _mm512_storeu_si512(
+            output + x,
+            _mm512_maskz_permutexvar_epi32(0xFFFF, order, _mm512_packus_epi16(low, high)));
+    }
+    convolution_quantized_elements(output, rows, weights, x, columns);
+}
+#endif
+
+/// \brief Signature of the quantized convolution of a row, such as
+/// \p convolution_quantized_row_scalar.
+using QuantizedRowFunction = void (*)(std::uint8_t*                 output,
+                                      const std::uint32_t* const*   rows,
+                                      const QuantizedKernelWeights& weights,
+                                      const std::size_t             columns);
+
+/// \brief Signature of the expansion of a row for the weights of a format, such as
+/// \p expand_quantized_row_avx2.
+using QuantizedExpandFunction = void (*)(const std::uint8_t* source,
+                                         const std::size_t   count,
+                                         std::uint32_t*      destination);
+
+/// \brief Expansion and row function of the quantized convolution.
+struct QuantizedKernels
+{
+    QuantizedExpandFunction expand = nullptr;
+    QuantizedRowFunction    row    = nullptr;
+};
+
+/// \brief \p expand_quantized_row for \p Format.
+template<QuantizedMaskFormat Format>
+void expand_quantized_row_scalar(const std::uint8_t* source,
+                                 const std::size_t   count,
+                                 std::uint32_t*      destination)
+{
+    expand_quantized_row(source, count, Format, destination);
+}
+
+/// \brief Returns the quantized kernels for \p level and the weights of \p Format.
+template<QuantizedMaskFormat Format>
+QuantizedKernels get_quantized_kernels(const SimdLevel level)
+{
+#ifdef CONVOLUTION_X86_SIMD
+    if(level == SimdLevel::avx512 && host_supports_avx512bw())
+    {
+        return {expand_quantized_row_avx512<Format>, convolution_quantized_row_avx512<Format>};
+    }
+    if(level >= SimdLevel::avx2)
+    {
+        return {expand_quantized_row_avx2<Format>, convolution_quantized_row_avx2<Format>};
+    }
+#else
+    (void)level;
+#endif
+    return {expand_quantized_row_scalar<Format>, convolution_quantized_row_scalar};
+}
+
+/// \brief Returns the quantized kernels for \p level and the weights of \p format. The AVX-512
+/// kernels also need the byte and word instructions, without which the AVX2 kernels are used.
+inline QuantizedKernels get_quantized_kernels(const SimdLevel           level,
+                                              const QuantizedMaskFormat format)
+{
+    return format == QuantizedMaskFormat::int8
+               ? get_quantized_kernels<QuantizedMaskFormat::int8>(level)
+               : get_quantized_kernels<QuantizedMaskFormat::int16>(level);
+}
+
+/// \brief Multithreaded quantized convolution of the \p width x \p height grid of 8-bit
+/// elements \p input, whose elements outside of the grid are derived with \p boundary, with the
+/// fixed-point \p mask. \p output has the size of the grid.
+///
+/// The rows are split across \p num_threads host threads (by default,
+/// \p get_default_host_threads()). Each thread keeps the <tt>mask_width</tt> input rows that an
+/// output row reads in a ring of row buffers, extended with the elements outside of the grid
+/// (see \p load_boundary_row) and expanded for the kernels (see \p expand_quantized_row), so
+/// every input row is expanded once per thread. The rows are computed by the kernels for
+/// \p simd_level, which is lowered to the level supported by the host if necessary, and all of
+/// them produce the same results.
+inline void convolution_quantized_cpu(std::uint8_t*        output,
+                                      const std::uint8_t*  input,
+                                      const unsigned int   width,
+                                      const unsigned int   height,
+                                      const BoundaryMode   boundary,
+                                      const QuantizedMask& mask,
+                                      const unsigned int   num_threads = 0,
+                                      const SimdLevel      simd_level  = get_host_simd_level())
+{
+    const QuantizedKernels kernels
+        = get_quantized_kernels(std::min(simd_level, get_host_simd_level()), mask.format);
+    const QuantizedKernelWeights weights(mask);
+    const std::ptrdiff_t         radius    = mask.width / 2;
+    const std::size_t            row_width = width + mask.width - 1 + quantized_row_padding;
+
+    const auto process_rows = [&](const std::size_t row_begin, const std::size_t row_end)
+    {
+        std::vector<std::uint8_t>          source(row_width + quantized_row_padding);
+        std::vector<std::uint32_t>         ring(mask.width * row_width);
+        std::vector<const std::uint32_t*>  rows(mask.width);
+
+        // Loads input row y, extended with the elements outside of the grid, and expands it into
+        // its buffer of the ring.
+        const auto load_row = [&](const std::ptrdiff_t y)
+        {
+            const std::ptrdiff_t source_y = resolve_boundary_index(y, height, boundary);
+            if(source_y < 0)
+            {
+                std::fill(source.begin(), source.end(), std::uint8_t{0});
+            }
+            else
+            {
+                load_boundary_row(input + source_y * static_cast<std::ptrdiff_t>(width),
+                                  width,
+                                  boundary,
+                                  -radius,
+                                  source.size(),
+                                  source.data());
+            }
+            kernels.expand(source.data(),
+                           row_width,
+                           ring.data() + (y + radius + mask.width) % mask.width * row_width);
+        };
+
+        // Output row y reads the mask.width input rows from y - radius on, so the ring is filled
+        // with all but the last of them before the first output row, which also holds for even
+        // mask widths.
+        const std::ptrdiff_t first_row = row_begin;
+        const std::ptrdiff_t last_rows = mask.width - 1;
+        for(std::ptrdiff_t y = first_row - radius; y < first_row - radius + last_rows; ++y)
+        {
+            load_row(y);
+        }
+        for(std::ptrdiff_t y = first_row; y < static_cast<std::ptrdiff_t>(row_end); ++y)
+        {
+            load_row(y - radius + last_rows);
+            for(unsigned int i = 0; i < mask.width; ++i)
+            {
+                rows[i] = ring.data() + (y + i + mask.width) % mask.width * row_width;
+            }
+            kernels.row(output + y * static_cast<std::ptrdiff_t>(width),
+                        rows.data(),
+                        weights,
+                        width);
+        }
+    };
+    parallel_for(height, 1, num_threads, process_rows);
+}
+
+#endif // _APPLICATIONS_CONVOLUTION_CONVOLUTION_QUANTIZED_HPP
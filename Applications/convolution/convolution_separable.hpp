@@ -0,0 +1,272 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_CONVOLUTION_CONVOLUTION_SEPARABLE_HPP
+#define _APPLICATIONS_CONVOLUTION_CONVOLUTION_SEPARABLE_HPP
+
+#include "convolution_boundary.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+/// \brief Rank-1 term of a mask: the outer product of a \p column and a \p row filter, that is,
+/// element <tt>(i, j)</tt> of the term is <tt>column[i] * row[j]</tt>.
+struct SeparableTerm
+{
+    std::vector<float> column;
+    std::vector<float> row;
+};
+
+/// \brief Approximation of a mask by a sum of rank-1 terms.
+struct MaskDecomposition
+{
+    /// Terms in order of decreasing contribution.
+    std::vector<SeparableTerm> terms;
+
+    /// Frobenius norm of the difference between the mask and the sum of the terms, relative to
+    /// the norm of the mask.
+    double relative_error = 0;
+
+    /// Singular values of the mask, in decreasing order.
+    std::vector<double> singular_values;
+};
+
+/// \brief Computes the singular value decomposition of the \p mask_width x \p mask_width \p mask
+/// and keeps the smallest number of rank-1 terms, up to \p max_terms, whose sum approximates the
+/// mask with a relative error of at most \p tolerance. If no such number exists, all
+/// \p max_terms terms are kept, and the error of the decomposition shows that it is not accurate
+/// enough.
+///
+/// The decomposition uses the one-sided Jacobi method: the columns of a copy of the mask are
+/// rotated in pairs until they are orthogonal, and the accumulated rotations V then satisfy
+/// <tt>mask * V = U * S</tt>. The norms of the columns of U * S are the singular values.
+inline MaskDecomposition decompose_mask(const float*       mask,
+                                        const unsigned int mask_width,
+                                        const double       tolerance,
+                                        const unsigned int max_terms)
+{
+    const unsigned int n = mask_width;
+
+    // Column-major copies of the mask (that becomes U * S) and of V.
+    std::vector<double> us(n * n);
+    std::vector<double> v(n * n, 0.0);
+    for(unsigned int i = 0; i < n; ++i)
+    {
+        for(unsigned int j = 0; j < n; ++j)
+        {
+            us[j * n + i] = mask[i * n + j];
+        }
+        v[i * n + i] = 1.0;
+    }
+
+    constexpr unsigned int max_sweeps = 64;
+    constexpr double       epsilon    = 1e-15;
+    for(unsigned int sweep = 0; sweep < max_sweeps; ++sweep)
+    {
+        bool rotated = false;
+        for(unsigned int p = 0; p + 1 < n; ++p)
+        {
+            for(unsigned int q = p + 1; q < n; ++q)
+            {
+                double* const column_p = us.data() + p * n;
+                double* const column_q = us.data() + q * n;
+                double        alpha = 0, beta = 0, gamma = 0;
+                for(unsigned int i = 0; i < n; ++i)
+                {
+                    alpha += column_p[i] * column_p[i];
+                    beta += column_q[i] * column_q[i];
+                    gamma += column_p[i] * column_q[i];
+                }
+                if(std::abs(gamma) <= epsilon * std::sqrt(alpha * beta))
+                {
+                    continue;
+                }
+                rotated = true;
+
+                // Rotation that makes columns p and q orthogonal.
+                const double zeta = (beta - alpha) / (2 * gamma);
+                const double t    = (zeta >= 0 ? 1.0 : -1.0)
+                                 / (std::abs(zeta) + std::sqrt(1 + zeta * zeta));
+                const double c = 1 / std::sqrt(1 + t * t);
+                const double s = c * t;
+                for(double* const matrix : {us.data(), v.data()})
+                {
+                    for(unsigned int i = 0; i < n; ++i)
+                    {
+                        const double a = matrix[p * n + i];
+                        const double b = matrix[q * n + i];
+                        matrix[p * n + i] = c * a - s * b;
+                        matrix[q * n + i] = s * a + c * b;
+                    }
+                }
+            }
+        }
+        if(!rotated)
+        {
+            break;
+        }
+    }
+
+    // Sort the terms by their singular value.
+    std::vector<double> singular_values(n);
+    for(unsigned int j = 0; j < n; ++j)
+    {
+        double norm = 0;
+        for(unsigned int i = 0; i < n; ++i)
+        {
+            norm += us[j * n + i] * us[j * n + i];
+        }
+        singular_values[j] = std::sqrt(norm);
+    }
+    std::vector<unsigned int> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(),
+                     order.end(),
+                     [&](const unsigned int a, const unsigned int b)
+                     { return singular_values[a] > singular_values[b]; });
+
+    MaskDecomposition decomposition;
+    for(const unsigned int j : order)
+    {
+        decomposition.singular_values.push_back(singular_values[j]);
+    }
+
+    // The squared error of the first r terms is the sum of the squares of the remaining
+    // singular values.
+    double total = 0;
+    for(const double value : singular_values)
+    {
+        total += value * value;
+    }
+    double remaining = total;
+    for(unsigned int r = 0; r < std::min(n, max_terms); ++r)
+    {
+        if(total == 0 || std::sqrt(remaining / total) <= tolerance)
+        {
+            break;
+        }
+
+        // Split the singular value evenly between the column and the row filter.
+        const unsigned int j      = order[r];
+        const double       sigma  = decomposition.singular_values[r];
+        const double       scale  = 1 / std::sqrt(sigma);
+        SeparableTerm      term;
+        for(unsigned int i = 0; i < n; ++i)
+        {
+            term.column.push_back(static_cast<float>(us[j * n + i] * scale));
+            term.row.push_back(static_cast<float>(v[j * n + i] * sigma * scale));
+        }
+        decomposition.terms.push_back(term);
+        remaining = std::max(0.0, remaining - sigma * sigma);
+    }
+    decomposition.relative_error = total == 0 ? 0 : std::sqrt(remaining / total);
+    return decomposition;
+}
+
+/// \brief Returns whether convolving with the \p terms of a decomposition of a \p mask_width x
+/// \p mask_width mask needs fewer multiply-adds per element than the direct convolution. A row
+/// and a column pass of \p mask_width elements are needed for every term.
+inline bool separable_is_cheaper(const std::size_t terms, const unsigned int mask_width)
+{
+    return 2 * terms * mask_width < static_cast<std::size_t>(mask_width) * mask_width;
+}
+
+/// \brief Multithreaded two-pass convolution of the grid of \p input with the sum of the
+/// rank-1 \p terms of a \p mask_width x \p mask_width mask. \p output has the size of the
+/// grid.
+///
+/// The output rows are processed in strips of \p strip_height rows, which are split across
+/// \p num_threads host threads (by default, \p get_default_host_threads()). For each term, the
+/// row filter is applied to the <tt>strip_height + mask_width - 1</tt> input rows that a strip
+/// depends on, and the column filter to the result, which is added to the output. The
+/// intermediate rows of a strip stay in cache, and both passes run along consecutive elements of
+/// a row, so they can be vectorized. Each input row is loaded into a row buffer with
+/// <tt>mask_width / 2</tt> elements on either side derived with the boundary mode of \p input
+/// (see \p load_input_row), so the row pass needs no checks for the edges.
+inline void convolution_separable_cpu(float*                            output,
+                                      const ConvolutionInput&           input,
+                                      const std::vector<SeparableTerm>& terms,
+                                      const unsigned int                mask_width,
+                                      const unsigned int                num_threads  = 0,
+                                      const unsigned int                strip_height = 32)
+{
+    const unsigned int   width        = input.width;
+    const std::ptrdiff_t radius       = mask_width / 2;
+    const std::size_t    padded_width = width + (mask_width / 2) * 2;
+
+    const auto process_strips = [&](const std::size_t row_begin, const std::size_t row_end)
+    {
+        std::vector<float> rows(static_cast<std::size_t>(strip_height + mask_width - 1) * width);
+        std::vector<float> input_row(padded_width);
+        for(std::size_t strip = row_begin; strip < row_end; strip += strip_height)
+        {
+            const std::size_t strip_rows = std::min<std::size_t>(strip_height, row_end - strip);
+            std::fill(output + strip * width, output + (strip + strip_rows) * width, 0.0f);
+
+            for(const SeparableTerm& term : terms)
+            {
+                // Row pass over the input rows of the strip.
+                for(std::size_t i = 0; i < strip_rows + mask_width - 1; ++i)
+                {
+                    load_input_row(input,
+                                   static_cast<std::ptrdiff_t>(strip + i) - radius,
+                                   -radius,
+                                   padded_width,
+                                   input_row.data());
+                    float* const row = rows.data() + i * width;
+                    std::fill(row, row + width, 0.0f);
+                    for(unsigned int j = 0; j < mask_width; ++j)
+                    {
+                        const float        weight   = term.row[j];
+                        const float* const elements = input_row.data() + j;
+                        for(unsigned int x = 0; x < width; ++x)
+                        {
+                            row[x] += elements[x] * weight;
+                        }
+                    }
+                }
+
+                // Column pass, accumulated into the output.
+                for(std::size_t y = 0; y < strip_rows; ++y)
+                {
+                    float* const output_row = output + (strip + y) * width;
+                    for(unsigned int i = 0; i < mask_width; ++i)
+                    {
+                        const float        weight = term.column[i];
+                        const float* const row    = rows.data() + (y + i) * width;
+                        for(unsigned int x = 0; x < width; ++x)
+                        {
+                            output_row[x] += row[x] * weight;
+                        }
+                    }
+                }
+            }
+        }
+    };
+    parallel_for(input.height, strip_height, num_threads, process_strips);
+}
+
+#endif // _APPLICATIONS_CONVOLUTION_CONVOLUTION_SEPARABLE_HPP
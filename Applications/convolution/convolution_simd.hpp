@@ -0,0 +1,369 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_CONVOLUTION_CONVOLUTION_SIMD_HPP
+#define _APPLICATIONS_CONVOLUTION_CONVOLUTION_SIMD_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+
+    #define CONVOLUTION_X86_SIMD
+    // GCC and Clang only allow intrinsics in functions compiled for the corresponding instruction
+    // set, while MSVC allows them anywhere.
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define CONVOLUTION_TARGET(isa)
+    #else
+        #define CONVOLUTION_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#endif
+
+// The vectorized kernels must not fuse their multiplications and additions, which would round
+// differently than the scalar versions. Compilers may do so in functions compiled for AVX-512,
+// which includes fused multiply-add instructions. Clang is told so in the function bodies, GCC
+// around the AVX-512 functions.
+#if defined(__clang__)
+    #define CONVOLUTION_FP_CONTRACT_OFF _Pragma("clang fp contract(off)")
+#else
+    #define CONVOLUTION_FP_CONTRACT_OFF
+#endif
+
+/// \brief Largest mask width for which the convolution kernels and CPU functions are specialized.
+constexpr unsigned int max_specialized_mask_width = 15;
+
+/// \brief Returns whether there are specializations of the convolution for masks of
+/// \p mask_width x \p mask_width elements: odd widths from 3 to \p max_specialized_mask_width.
+constexpr bool is_specialized_mask_width(const unsigned int mask_width)
+{
+    return mask_width >= 3 && mask_width <= max_specialized_mask_width && mask_width % 2 == 1;
+}
+
+/// \brief Number of consecutive output elements of which the specializations of
+/// \p convolution_tile_scalar keep the partial sums in registers.
+constexpr unsigned int convolution_rows_block = 16;
+
+/// \brief Number of vectors of consecutive output elements that the vectorized kernels compute
+/// at once. Their partial sums stay in registers for the whole mask.
+constexpr unsigned int convolution_tile_vectors = 4;
+
+/// \brief Direct convolution of a tile of \p rows x \p columns output elements with the
+/// \p mask_width x \p mask_width \p mask. Output element <tt>(y, x)</tt>, which is stored to
+/// <tt>output[y * output_stride + x]</tt>, is the sum of the products of the mask elements
+/// <tt>(i, j)</tt> and the input elements <tt>input[(y + i) * input_stride + x + j]</tt>, so
+/// \p input points to the top left input element of the tile. All of them must be stored.
+///
+/// The generic version (\p MaskWidth = 0) accumulates one mask element at a time over the whole
+/// row of the tile, so that the inner loop runs along consecutive elements and can be
+/// vectorized. The specializations for a fixed \p MaskWidth, which must then equal
+/// \p mask_width, unroll a row of the mask instead, so that the partial sums of a block of
+/// \p convolution_rows_block consecutive elements stay in registers for the whole row of the
+/// mask. In both cases, the terms of every element are added in the order of the mask elements,
+/// like in \p convolution_reference, so the results are identical.
+template<unsigned int MaskWidth>
+void convolution_tile_scalar(float*             output,
+                             const std::size_t  output_stride,
+                             const float*       input,
+                             const std::size_t  input_stride,
+                             const float*       mask,
+                             const unsigned int mask_width,
+                             const std::size_t  rows,
+                             const std::size_t  columns)
+{
+    for(std::size_t y = 0; y < rows; ++y)
+    {
+        float* const output_row = output + y * output_stride;
+        std::fill(output_row, output_row + columns, 0.0f);
+        for(unsigned int mask_index_y = 0; mask_index_y < mask_width; ++mask_index_y)
+        {
+            const float* const input_row = input + (y + mask_index_y) * input_stride;
+            const float* const mask_row = mask + mask_index_y * mask_width;
+            if constexpr(MaskWidth != 0)
+            {
+                float weights[MaskWidth];
+                std::copy(mask_row, mask_row + MaskWidth, weights);
+                std::size_t x = 0;
+                for(; x + convolution_rows_block <= columns; x += convolution_rows_block)
+                {
+                    float sums[convolution_rows_block];
+                    std::copy(output_row + x, output_row + x + convolution_rows_block, sums);
+                    for(unsigned int mask_index_x = 0; mask_index_x < MaskWidth; ++mask_index_x)
+                    {
+                        const float* const input = input_row + x + mask_index_x;
+                        for(unsigned int i = 0; i < convolution_rows_block; ++i)
+                        {
+                            sums[i] += input[i] * weights[mask_index_x];
+                        }
+                    }
+                    std::copy(sums, sums + convolution_rows_block, output_row + x);
+                }
+                for(; x < columns; ++x)
+                {
+                    float sum = output_row[x];
+                    for(unsigned int mask_index_x = 0; mask_index_x < MaskWidth; ++mask_index_x)
+                    {
+                        sum += input_row[x + mask_index_x] * weights[mask_index_x];
+                    }
+                    output_row[x] = sum;
+                }
+            }
+            else
+            {
+                for(unsigned int mask_index_x = 0; mask_index_x < mask_width; ++mask_index_x)
+                {
+                    const float        weight = mask_row[mask_index_x];
+                    const float* const input  = input_row + mask_index_x;
+                    for(std::size_t x = 0; x < columns; ++x)
+                    {
+                        output_row[x] += input[x] * weight;
+                    }
+                }
+            }
+        }
+    }
+}
+
+#ifdef CONVOLUTION_X86_SIMD
+/// \brief Computes the \p Vectors x 8 consecutive output elements of \p output whose top left input
+/// element is \p input, in rows of \p input_stride elements, with AVX2. The mask is read from
+/// \p weights, in which the specializations have broadcast it, or from \p mask for the generic
+/// version.
+template<unsigned int Vectors, unsigned int MaskWidth>
+CONVOLUTION_TARGET("avx2")
+inline void convolution_block_avx2(float*             output,
+                                   const float*       input,
+                                   const std::size_t  input_stride,
+                                   const __m256*      weights,
+                                   const float*       mask,
+                                   const unsigned int runtime_mask_width)
+{
+    CONVOLUTION_FP_CONTRACT_OFF
+    const unsigned int mask_width = MaskWidth != 0 ? MaskWidth : runtime_mask_width;
+
+    __m256 sums[Vectors];
+    for(unsigned int v = 0; v < Vectors; ++v)
+    {
+        sums[v] = _mm256_setzero_ps();
+    }
+    for(unsigned int mask_index_y = 0; mask_index_y < mask_width; ++mask_index_y)
+    {
+        const float* const input_row = input + mask_index_y * input_stride;
+        for(unsigned int mask_index_x = 0; mask_index_x < mask_width; ++mask_index_x)
+        {
+            const unsigned int mask_index = mask_index_y * mask_width + mask_index_x;
+            const __m256       weight
+                = MaskWidth != 0 ? weights[mask_index] : _mm256_set1_ps(mask[mask_index]);
+            for(unsigned int v = 0; v < Vectors; ++v)
+            {
+                const __m256 element = _mm256_loadu_ps(input_row + mask_index_x + v * 8);
+                sums[v]              = _mm256_add_ps(sums[v], _mm256_mul_ps(element, weight));
+            }
+        }
+    }
+    for(unsigned int v = 0; v < Vectors; ++v)
+    {
+        _mm256_storeu_ps(output + v * 8, sums[v]);
+    }
+}
+
+/// \brief AVX2 version of \p convolution_tile_scalar, which computes
+/// \p convolution_tile_vectors vectors of consecutive output elements at once and reads every
+/// input vector with an unaligned load at each horizontal offset of the mask. The partial sums
+/// are added in the same order as in the scalar version, without fused multiply-adds, so the
+/// results are identical. The remaining elements of each row are computed by the scalar
+/// version.
+template<unsigned int MaskWidth>
+CONVOLUTION_TARGET("avx2")
+void convolution_tile_avx2(float*             output,
+                           const std::size_t  output_stride,
+                           const float*       input,
+                           const std::size_t  input_stride,
+                           const float*       mask,
+                           const unsigned int mask_width,
+                           const std::size_t  rows,
+                           const std::size_t  columns)
+{
+    constexpr std::size_t vector_size = 8;
+    constexpr std::size_t block_size  = convolution_tile_vectors * vector_size;
+
+    // The specializations broadcast the whole mask once, so that the unrolled loops can keep as
+    // much of it in registers as these can hold.
+    __m256 weights[MaskWidth != 0 ? MaskWidth * MaskWidth : 1];
+    if constexpr(MaskWidth != 0)
+    {
+        for(unsigned int i = 0; i < MaskWidth * MaskWidth; ++i)
+        {
+            weights[i] = _mm256_set1_ps(mask[i]);
+        }
+    }
+
+    for(std::size_t y = 0; y < rows; ++y)
+    {
+        const float* const input_row  = input + y * input_stride;
+        float* const       output_row = output + y * output_stride;
+        std::size_t        x          = 0;
+        for(; x + block_size <= columns; x += block_size)
+        {
+            convolution_block_avx2<convolution_tile_vectors, MaskWidth>(output_row + x,
+                                                                         input_row + x,
+                                                                         input_stride,
+                                                                         weights,
+                                                                         mask,
+                                                                         mask_width);
+        }
+        for(; x + vector_size <= columns; x += vector_size)
+        {
+            convolution_block_avx2<1, MaskWidth>(output_row + x,
+                                                 input_row + x,
+                                                 input_stride,
+                                                 weights,
+                                                 mask,
+                                                 mask_width);
+        }
+        convolution_tile_scalar<MaskWidth>(output_row + x,
+                                           output_stride,
+                                           input_row + x,
+                                           input_stride,
+                                           mask,
+                                           mask_width,
+                                           1,
+                                           columns - x);
+    }
+}
+
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC push_options
+        #pragma GCC optimize("fp-contract=off")
+    #endif
+
+/// \brief Computes the \p Vectors x 16 consecutive output elements of \p output whose top left
+/// input element is \p input with AVX-512, like \p convolution_block_avx2. Only the elements of
+/// the last vector that are selected by \p active are loaded and stored.
+template<unsigned int Vectors, unsigned int MaskWidth>
+CONVOLUTION_TARGET("avx512f")
+inline void convolution_block_avx512(float*             output,
+                                     const float*       input,
+                                     const std::size_t  input_stride,
+                                     const __m512*      weights,
+                                     const float*       mask,
+                                     const unsigned int runtime_mask_width,
+                                     const __mmask16    active)
+{
+    CONVOLUTION_FP_CONTRACT_OFF
+    const unsigned int mask_width = MaskWidth != 0 ? MaskWidth : runtime_mask_width;
+
+    __m512 sums[Vectors];
+    for(unsigned int v = 0; v < Vectors; ++v)
+    {
+        sums[v] = _mm512_setzero_ps();
+    }
+    for(unsigned int mask_index_y = 0; mask_index_y < mask_width; ++mask_index_y)
+    {
+        const float* const input_row = input + mask_index_y * input_stride;
+        for(unsigned int mask_index_x = 0; mask_index_x < mask_width; ++mask_index_x)
+        {
+            const unsigned int mask_index = mask_index_y * mask_width + mask_index_x;
+            const __m512       weight
+                = MaskWidth != 0 ? weights[mask_index] : _mm512_set1_ps(mask[mask_index]);
+            for(unsigned int v = 0; v + 1 < Vectors; ++v)
+            {
+                const __m512 element = _mm512_loadu_ps(input_row + mask_index_x + v * 16);
+                sums[v]              = _mm512_add_ps(sums[v], _mm512_mul_ps(element, weight));
+            }
+            const __m512 element
+                = _mm512_maskz_loadu_ps(active, input_row + mask_index_x + (Vectors - 1) * 16);
+            sums[Vectors - 1]
+                = _mm512_add_ps(sums[Vectors - 1], _mm512_mul_ps(element, weight));
+        }
+    }
+    for(unsigned int v = 0; v + 1 < Vectors; ++v)
+    {
+        _mm512_storeu_ps(output + v * 16, sums[v]);
+    }
+    _mm512_mask_storeu_ps(output + (Vectors - 1) * 16, active, sums[Vectors - 1]);
+}
+
+/// \brief AVX-512 version of \p convolution_tile_scalar, like \p convolution_tile_avx2. The
+/// remaining elements of each row are computed with masked loads and stores instead of the
+/// scalar version.
+template<unsigned int MaskWidth>
+CONVOLUTION_TARGET("avx512f")
+void convolution_tile_avx512(float*             output,
+                             const std::size_t  output_stride,
+                             const float*       input,
+                             const std::size_t  input_stride,
+                             const float*       mask,
+                             const unsigned int mask_width,
+                             const std::size_t  rows,
+                             const std::size_t  columns)
+{
+    constexpr std::size_t vector_size = 16;
+    constexpr std::size_t block_size  = convolution_tile_vectors * vector_size;
+
+    __m512 weights[MaskWidth != 0 ? MaskWidth * MaskWidth : 1];
+    if constexpr(MaskWidth != 0)
+    {
+        for(unsigned int i = 0; i < MaskWidth * MaskWidth; ++i)
+        {
+            weights[i] = _mm512_set1_ps(mask[i]);
+        }
+    }
+
+    for(std::size_t y = 0; y < rows; ++y)
+    {
+        const float* const input_row  = input + y * input_stride;
+        float* const       output_row = output + y * output_stride;
+        std::size_t        x          = 0;
+        for(; x + block_size <= columns; x += block_size)
+        {
+            convolution_block_avx512<convolution_tile_vectors, MaskWidth>(output_row + x,
+                                                                           input_row + x,
+                                                                           input_stride,
+                                                                           weights,
+                                                                           mask,
+                                                                           mask_width,
+                                                                           0xFFFF);
+        }
+        for(; x < columns; x += vector_size)
+        {
+            const __mmask16 active
+                = columns - x >= vector_size
+                      ? __mmask16{0xFFFF}
+                      : static_cast<__mmask16>((1u << (columns - x)) - 1);
+            convolution_block_avx512<1, MaskWidth>(output_row + x,
+                                                   input_row + x,
+                                                   input_stride,
+                                                   weights,
+                                                   mask,
+                                                   mask_width,
+                                                   active);
+        }
+    }
+}
+
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC pop_options
+    #endif
+#endif
+
+#endif // _APPLICATIONS_CONVOLUTION_CONVOLUTION_SIMD_HPP
@@ -0,0 +1,328 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_CONVOLUTION_CONVOLUTION_STREAM_HPP
+#define _APPLICATIONS_CONVOLUTION_CONVOLUTION_STREAM_HPP
+
+#include "convolution_boundary.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/// \brief Reads the rows <tt>[first_row, first_row + rows)</tt> of a grid of floats, and stores
+/// row <tt>first_row + i</tt> to <tt>destination + i * stride</tt>. Returns false on failure.
+using GridRowReader = std::function<bool(std::size_t first_row,
+                                         std::size_t rows,
+                                         float*      destination,
+                                         std::size_t stride)>;
+
+/// \brief Writes the rows <tt>[first_row, first_row + rows)</tt> of a grid of floats, which are
+/// stored consecutively in \p source. Returns false on failure.
+using GridRowWriter
+    = std::function<bool(std::size_t first_row, std::size_t rows, const float* source)>;
+
+/// \brief Convolves the grid of \p input, which can be a band of a larger grid with
+/// <tt>mask_width / 2</tt> halo rows, and stores the result to \p output, like
+/// \p convolution_direct_cpu.
+using BandConvolution = std::function<void(float* output, const ConvolutionInput& input)>;
+
+/// \brief Opens the file \p file_name, which contains a \p width x \p height grid of floats in
+/// row-major order without a header, for reading with \p reader.
+inline bool open_grid_file_reader(const std::string& file_name,
+                                  const unsigned int width,
+                                  const unsigned int height,
+                                  GridRowReader&     reader)
+{
+    const auto file = std::make_shared<std::ifstream>(file_name, std::ios::binary);
+    if(!*file)
+    {
+        std::cerr << "Cannot open grid file \"" << file_name << "\"." << std::endl;
+        return false;
+    }
+    const std::size_t row_bytes = std::size_t{width} * sizeof(float);
+    file->seekg(0, std::ios::end);
+    if(static_cast<std::size_t>(file->tellg()) != row_bytes * height)
+    {
+        std::cerr << "Grid file \"" << file_name << "\" does not contain " << width << " x "
+                  << height << " floats." << std::endl;
+        return false;
+    }
+    reader = [file, row_bytes](const std::size_t first_row,
+                               const std::size_t rows,
+                               float*            destination,
+                               const std::size_t stride)
+    {
+        file->seekg(static_cast<std::streamoff>(first_row * row_bytes));
+        for(std::size_t row = 0; row < rows; ++row)
+        {
+            file->read(reinterpret_cast<char*>(destination + row * stride),
+                       static_cast<std::streamsize>(row_bytes));
+        }
+        return static_cast<bool>(*file);
+    };
+    return true;
+}
+
+/// \brief Creates the file \p file_name for writing a grid of floats of \p width columns in
+/// row-major order with \p writer.
+inline bool open_grid_file_writer(const std::string& file_name,
+                                  const unsigned int width,
+                                  GridRowWriter&     writer)
+{
+    const auto file = std::make_shared<std::ofstream>(file_name, std::ios::binary);
+    if(!*file)
+    {
+        std::cerr << "Cannot create grid file \"" << file_name << "\"." << std::endl;
+        return false;
+    }
+    const std::size_t row_bytes = std::size_t{width} * sizeof(float);
+    writer = [file, row_bytes](const std::size_t first_row,
+                               const std::size_t rows,
+                               const float*      source)
+    {
+        file->seekp(static_cast<std::streamoff>(first_row * row_bytes));
+        file->write(reinterpret_cast<const char*>(source),
+                    static_cast<std::streamsize>(rows * row_bytes));
+        file->flush();
+        return static_cast<bool>(*file);
+    };
+    return true;
+}
+
+/// \brief Returns a reader of a \p width wide grid of random floats between 0 and 256. Every row
+/// is generated from its own seed, so rows can be read in any order and are the same each time.
+inline GridRowReader make_random_grid_reader(const unsigned int width, const unsigned int seed)
+{
+    return [width, seed](const std::size_t first_row,
+                         const std::size_t rows,
+                         float*            destination,
+                         const std::size_t stride)
+    {
+        std::uniform_real_distribution<float> distribution{0, 256};
+        for(std::size_t row = 0; row < rows; ++row)
+        {
+            std::seed_seq seed_sequence{seed, static_cast<unsigned int>(first_row + row)};
+            std::mt19937  random_engine(seed_sequence);
+            std::generate(destination + row * stride,
+                          destination + row * stride + width,
+                          [&] { return distribution(random_engine); });
+        }
+        return true;
+    };
+}
+
+/// \brief Statistics of \p convolution_stream.
+struct StreamStatistics
+{
+    /// Number of bands.
+    std::size_t bands = 0;
+
+    /// Total size of the band buffers in bytes, the peak memory use besides the convolution.
+    std::size_t buffer_bytes = 0;
+
+    /// Number of bytes read from the input and written to the output.
+    std::size_t bytes_read    = 0;
+    std::size_t bytes_written = 0;
+
+    /// Time in seconds spent convolving the bands, and waiting for reads and writes to finish.
+    double compute_seconds = 0;
+    double wait_seconds    = 0;
+};
+
+/// \brief Convolves the \p width x \p height grid read by \p reader with a mask of width
+/// \p mask_width and the boundary mode \p boundary in horizontal bands of \p band_rows rows,
+/// and writes the result with \p writer.
+///
+/// Each band is read into a buffer with <tt>mask_width / 2</tt> halo rows above and below it,
+/// convolved by \p convolve_band, and written from an output buffer. The halo rows outside of
+/// the grid are derived with \p boundary, reading the rows they stand for if necessary, while
+/// the columns outside of the grid are left to \p convolve_band. There are two of each buffer:
+/// while a band is convolved, the next one is read on another thread, and the previous one is
+/// written on a third, so reading and writing overlap with the computation. The halo rows above
+/// a band are copied from the buffer of the previous band instead of being read again. Hence the
+/// memory use is proportional to the size of a band, regardless of the height of the grid, and
+/// every input element is read once, besides the rows that halo rows outside of the grid stand
+/// for. Returns false if reading or writing fails.
+inline bool convolution_stream(const GridRowReader&   reader,
+                               const GridRowWriter&   writer,
+                               const unsigned int     width,
+                               const unsigned int     height,
+                               const unsigned int     mask_width,
+                               const BoundaryMode     boundary,
+                               unsigned int           band_rows,
+                               const BandConvolution& convolve_band,
+                               StreamStatistics&      statistics)
+{
+    band_rows                     = std::max(1u, std::min(band_rows, height));
+    const std::size_t radius      = mask_width / 2;
+    const std::size_t padded_rows = band_rows + radius * 2;
+    const std::size_t row_size    = width;
+    const std::size_t bands       = ceiling_div(height, band_rows);
+
+    std::vector<float> input_bands[2];
+    std::vector<float> output_bands[2];
+    for(unsigned int i = 0; i < 2; ++i)
+    {
+        input_bands[i].assign(padded_rows * row_size, 0.0f);
+        output_bands[i].resize(std::size_t{band_rows} * width);
+    }
+
+    statistics              = StreamStatistics{};
+    statistics.bands        = bands;
+    statistics.buffer_bytes = 2 * (input_bands[0].size() + output_bands[0].size()) * sizeof(float);
+
+    const auto band_begin = [&](const std::size_t band) { return band * band_rows; };
+    const auto band_size  = [&](const std::size_t band)
+    { return std::min<std::size_t>(band_rows, height - band_begin(band)); };
+
+    // Fills the input buffer of a band. Row j of the buffer holds row band_begin - radius + j of
+    // the grid.
+    const auto read_band = [&](const std::size_t band)
+    {
+        float* const buffer = input_bands[band % 2].data();
+        std::size_t  filled = 0;
+        if(band != 0)
+        {
+            // The rows around the border to the previous band, which has band_rows rows.
+            const float* const previous = input_bands[(band - 1) % 2].data();
+            std::copy(previous + band_rows * row_size,
+                      previous + (band_rows + radius * 2) * row_size,
+                      buffer);
+            filled = radius * 2;
+        }
+
+        // The remaining rows inside of the grid are read at once.
+        const std::ptrdiff_t first_row
+            = static_cast<std::ptrdiff_t>(band_begin(band)) - static_cast<std::ptrdiff_t>(radius);
+        const std::ptrdiff_t last_row
+            = first_row + static_cast<std::ptrdiff_t>(band_size(band) + radius * 2);
+        const std::ptrdiff_t inside_begin
+            = std::max<std::ptrdiff_t>(0, first_row + static_cast<std::ptrdiff_t>(filled));
+        const std::ptrdiff_t inside_end
+            = std::max(inside_begin, std::min<std::ptrdiff_t>(last_row, height));
+        bool success = true;
+        if(inside_begin < inside_end)
+        {
+            const std::size_t rows = inside_end - inside_begin;
+            statistics.bytes_read += rows * width * sizeof(float);
+            success = reader(inside_begin,
+                             rows,
+                             buffer + (inside_begin - first_row) * row_size,
+                             row_size);
+        }
+
+        // The rows outside of the grid.
+        for(std::ptrdiff_t y = first_row + static_cast<std::ptrdiff_t>(filled);
+            y < last_row && success;
+            ++y)
+        {
+            if(y >= inside_begin && y < inside_end)
+            {
+                continue;
+            }
+            float* const         row    = buffer + (y - first_row) * row_size;
+            const std::ptrdiff_t source = resolve_boundary_index(y, height, boundary);
+            if(source < 0)
+            {
+                std::fill(row, row + row_size, 0.0f);
+            }
+            else
+            {
+                statistics.bytes_read += width * sizeof(float);
+                success = reader(source, 1, row, row_size);
+            }
+        }
+        return success;
+    };
+    const auto write_band = [&](const std::size_t band)
+    {
+        statistics.bytes_written += band_size(band) * width * sizeof(float);
+        return writer(band_begin(band), band_size(band), output_bands[band % 2].data());
+    };
+
+    // Waits for a pending read or write and accounts for the time spent waiting.
+    const auto wait = [&](std::future<bool>& pending)
+    {
+        HostClock clock;
+        clock.start_timer();
+        const bool result = pending.get();
+        clock.stop_timer();
+        statistics.wait_seconds += clock.get_elapsed_time();
+        return result;
+    };
+
+    std::future<bool> pending_read = std::async(std::launch::async, read_band, 0);
+    std::future<bool> pending_write;
+    bool              success = true;
+    for(std::size_t band = 0; band < bands && success; ++band)
+    {
+        success = wait(pending_read);
+        if(!success)
+        {
+            break;
+        }
+        // The buffer of the next band was used by the previous one, which is done.
+        if(band + 1 < bands)
+        {
+            pending_read = std::async(std::launch::async, read_band, band + 1);
+        }
+
+        HostClock clock;
+        clock.start_timer();
+        convolve_band(output_bands[band % 2].data(),
+                      ConvolutionInput{input_bands[band % 2].data() + radius * row_size,
+                                       width,
+                                       static_cast<unsigned int>(band_size(band)),
+                                       boundary,
+                                       static_cast<unsigned int>(radius)});
+        clock.stop_timer();
+        statistics.compute_seconds += clock.get_elapsed_time();
+
+        // Only one write is pending at a time, so the output buffer of the next band is free
+        // once this one is written.
+        if(pending_write.valid())
+        {
+            success = wait(pending_write);
+        }
+        pending_write = std::async(std::launch::async, write_band, band);
+    }
+    if(pending_read.valid())
+    {
+        pending_read.wait();
+    }
+    if(pending_write.valid())
+    {
+        success = wait(pending_write) && success;
+    }
+    return success;
+}
+
+#endif // _APPLICATIONS_CONVOLUTION_CONVOLUTION_STREAM_HPP
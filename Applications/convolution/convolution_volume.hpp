@@ -0,0 +1,430 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#ifndef _APPLICATIONS_CONVOLUTION_CONVOLUTION_VOLUME_HPP
+#define _APPLICATIONS_CONVOLUTION_CONVOLUTION_VOLUME_HPP
+
+#include "convolution_boundary.hpp"
+#include "convolution_cpu.hpp"
+#include "convolution_separable.hpp"
+#include "convolution_stream.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <utility>
+#include <vector>
+
+/// \brief Dimensions of a volume of \p width x \p height x \p depth elements, stored plane by
+/// plane and row by row. A volume is read and written as a grid of \p width columns and
+/// <tt>height * depth</tt> rows, so the grid readers and writers of \p convolution_stream also
+/// stream volumes.
+struct VolumeShape
+{
+    unsigned int width  = 0;
+    unsigned int height = 0;
+    unsigned int depth  = 0;
+
+    /// \brief Number of elements of a plane.
+    std::size_t plane_size() const
+    {
+        return static_cast<std::size_t>(width) * height;
+    }
+
+    /// \brief Number of elements of the volume.
+    std::size_t size() const
+    {
+        return plane_size() * depth;
+    }
+};
+
+/// \brief Algorithms of the volumetric convolution.
+enum class VolumeAlgorithm
+{
+    direct,
+    separable
+};
+
+/// \brief Returns the name of a \p VolumeAlgorithm.
+inline const char* volume_algorithm_name(const VolumeAlgorithm algorithm)
+{
+    return algorithm == VolumeAlgorithm::separable ? "separable" : "direct";
+}
+
+/// \brief Cubic mask of a volumetric convolution: \p width x \p width x \p width \p weights,
+/// stored plane by plane and row by row. If the mask is the outer product of three filters of
+/// \p width elements, that is, weight <tt>(z, y, x)</tt> is
+/// <tt>filter_z[z] * filter_y[y] * filter_x[x]</tt>, they are stored as well, otherwise the
+/// filters are empty.
+struct VolumeMask
+{
+    unsigned int       width = 0;
+    std::vector<float> weights;
+    std::vector<float> filter_x;
+    std::vector<float> filter_y;
+    std::vector<float> filter_z;
+
+    /// \brief Returns whether the mask is the outer product of its filters.
+    bool separable() const
+    {
+        return !filter_x.empty();
+    }
+
+    /// \brief Returns the number of multiply-adds per element of \p algorithm.
+    std::size_t multiply_adds(const VolumeAlgorithm algorithm) const
+    {
+        return algorithm == VolumeAlgorithm::separable
+                   ? std::size_t{3} * width
+                   : static_cast<std::size_t>(width) * width * width;
+    }
+};
+
+/// \brief Returns the separable mask that is the outer product of \p filter_z, \p filter_y and
+/// \p filter_x, which have the same number of elements.
+inline VolumeMask make_separable_volume_mask(const std::vector<float>& filter_x,
+                                             const std::vector<float>& filter_y,
+                                             const std::vector<float>& filter_z)
+{
+    VolumeMask mask;
+    mask.width    = static_cast<unsigned int>(filter_x.size());
+    mask.filter_x = filter_x;
+    mask.filter_y = filter_y;
+    mask.filter_z = filter_z;
+    mask.weights.reserve(static_cast<std::size_t>(mask.width) * mask.width * mask.width);
+    for(const float z : filter_z)
+    {
+        for(const float y : filter_y)
+        {
+            for(const float x : filter_x)
+            {
+                mask.weights.push_back(z * y * x);
+            }
+        }
+    }
+    return mask;
+}
+
+/// \brief Number of output rows of a plane that \p convolution_volume_stream computes at once
+/// with the direct algorithm.
+constexpr unsigned int volume_convolution_block_rows = 32;
+
+/// \brief Number of output elements of a plane that \p convolution_volume_stream computes at
+/// once in the z pass of the separable algorithm.
+constexpr std::size_t volume_convolution_z_chunk = 4096;
+
+/// \brief Convolves the volume of \p shape read by \p reader with \p mask and the boundary mode
+/// \p boundary by \p algorithm, streaming it plane by plane along z, and writes the result with
+/// \p writer.
+///
+/// Only the \p mask.width planes that an output plane depends on are resident, in a ring
+/// buffer in which every plane read replaces the one that the next output plane no longer
+/// needs. With the direct algorithm, the ring holds input planes, and an output plane is the sum
+/// of the 2-D convolutions of each of them with the matching plane of the cubic mask by the tile
+/// kernels of \p convolution_direct_cpu, computed in blocks of
+/// \p volume_convolution_block_rows rows, so that the partial sums of a block are added while
+/// they are still in the cache. With the separable algorithm, every plane is convolved with the
+/// x and y filters by \p convolution_separable_cpu as it is read, so the ring holds filtered
+/// planes, and an output plane is their sum weighted by the z filter: 3 * \p mask.width instead
+/// of <tt>mask.width^3</tt> multiply-adds per element. The elements outside of a plane are
+/// derived with \p boundary on the fly, as in the 2-D convolution, and the planes outside of
+/// the volume are read again for the planes they stand for, or skipped if they are zero.
+///
+/// While a plane is convolved, the next one is read on another thread, and the previous output
+/// plane is written on a third, like the bands of \p convolution_stream, so the memory use is
+/// <tt>mask.width + 3</tt> planes regardless of the depth of the volume. The planes are split
+/// across \p num_threads host threads (by default, \p get_default_host_threads()), and the tiles
+/// of the direct algorithm are computed with \p simd_level, which is lowered to the level
+/// supported by the host if necessary. \p statistics.bands is the number of planes. Returns
+/// false if reading or writing fails.
+inline bool convolution_volume_stream(const GridRowReader&  reader,
+                                      const GridRowWriter&  writer,
+                                      const VolumeShape&    shape,
+                                      const VolumeMask&     mask,
+                                      const VolumeAlgorithm algorithm,
+                                      const BoundaryMode    boundary,
+                                      const unsigned int    num_threads,
+                                      const SimdLevel       simd_level,
+                                      StreamStatistics&     statistics)
+{
+    const std::size_t    plane_size = shape.plane_size();
+    const std::size_t    mask_size  = static_cast<std::size_t>(mask.width) * mask.width;
+    const std::size_t    planes     = mask.width;
+    const std::ptrdiff_t depth      = shape.depth;
+    const std::ptrdiff_t radius     = mask.width / 2;
+    // Number of planes after an output plane that it depends on, radius for odd mask widths.
+    const std::ptrdiff_t after = static_cast<std::ptrdiff_t>(mask.width) - 1 - radius;
+    const bool           separable = algorithm == VolumeAlgorithm::separable;
+
+    const ConvolutionTileFunction convolution_tile
+        = get_convolution_tile_function(std::min(simd_level, get_host_simd_level()), mask.width);
+    const std::vector<SeparableTerm> terms{SeparableTerm{mask.filter_y, mask.filter_x}};
+
+    // Slot (q + radius) % planes of the ring holds plane q, which can be outside of the volume.
+    // Planes that are zero are not stored.
+    std::vector<std::vector<float>> ring(planes, std::vector<float>(plane_size));
+    std::vector<char>               stored(planes, 0);
+    std::vector<float>              incoming(plane_size);
+    bool                            incoming_stored = false;
+    std::vector<float>              output_planes[2];
+    for(unsigned int i = 0; i < 2; ++i)
+    {
+        output_planes[i].resize(plane_size);
+    }
+
+    statistics              = StreamStatistics{};
+    statistics.bands        = shape.depth;
+    statistics.buffer_bytes = (planes + 3) * plane_size * sizeof(float);
+
+    // Reads the plane that plane q stands for into the incoming buffer.
+    const auto read_plane = [&](const std::ptrdiff_t q)
+    {
+        const std::ptrdiff_t source = resolve_boundary_index(q, depth, boundary);
+        incoming_stored             = source >= 0;
+        if(!incoming_stored)
+        {
+            return true;
+        }
+        statistics.bytes_read += plane_size * sizeof(float);
+        return reader(source * shape.height, shape.height, incoming.data(), shape.width);
+    };
+    const auto write_plane = [&](const std::ptrdiff_t z)
+    {
+        statistics.bytes_written += plane_size * sizeof(float);
+        return writer(z * shape.height, shape.height, output_planes[z % 2].data());
+    };
+
+    // Moves the incoming plane q into the ring, filtered along x and y by the separable
+    // algorithm.
+    const auto store_plane = [&](const std::ptrdiff_t q)
+    {
+        const std::size_t slot = (q + radius) % planes;
+        stored[slot]           = incoming_stored;
+        if(incoming_stored && separable)
+        {
+            convolution_separable_cpu(ring[slot].data(),
+                                      ConvolutionInput{incoming.data(),
+                                                       shape.width,
+                                                       shape.height,
+                                                       boundary},
+                                      terms,
+                                      mask.width,
+                                      num_threads);
+        }
+        else if(incoming_stored)
+        {
+            std::swap(ring[slot], incoming);
+        }
+    };
+
+    // Computes output plane z from planes [z - radius, z + after], which are in slots
+    // (z + i) % planes.
+    const auto convolve_direct = [&](const std::size_t z, float* const output)
+    {
+        const auto process_blocks = [&](const std::size_t block_begin, const std::size_t block_end)
+        {
+            std::vector<float> block;
+            std::vector<float> partial;
+            for(std::size_t b = block_begin; b < block_end; ++b)
+            {
+                const std::size_t row_begin = b * volume_convolution_block_rows;
+                const std::size_t row_end   = std::min<std::size_t>(
+                    shape.height, row_begin + volume_convolution_block_rows);
+                const std::size_t block_size = (row_end - row_begin) * shape.width;
+                float* const      out        = output + row_begin * shape.width;
+                bool              first      = true;
+                partial.resize(block_size);
+                for(std::size_t i = 0; i < planes; ++i)
+                {
+                    const std::size_t slot = (z + i) % planes;
+                    if(!stored[slot])
+                    {
+                        continue;
+                    }
+                    convolution_direct_rows(first ? out : partial.data(),
+                                            ConvolutionInput{ring[slot].data(),
+                                                             shape.width,
+                                                             shape.height,
+                                                             boundary},
+                                            mask.weights.data() + i * mask_size,
+                                            mask.width,
+                                            convolution_tile,
+                                            row_begin,
+                                            row_end,
+                                            block);
+                    if(!first)
+                    {
+                        for(std::size_t j = 0; j < block_size; ++j)
+                        {
+                            out[j] += partial[j];
+                        }
+                    }
+                    first = false;
+                }
+            }
+        };
+        parallel_for(ceiling_div(shape.height, volume_convolution_block_rows),
+                     1,
+                     num_threads,
+                     process_blocks);
+    };
+    const auto convolve_separable = [&](const std::size_t z, float* const output)
+    {
+        const auto process_chunks = [&](const std::size_t begin, const std::size_t end)
+        {
+            for(std::size_t chunk = begin; chunk < end; chunk += volume_convolution_z_chunk)
+            {
+                const std::size_t chunk_end = std::min(end, chunk + volume_convolution_z_chunk);
+                std::fill(output + chunk, output + chunk_end, 0.0f);
+                for(std::size_t i = 0; i < planes; ++i)
+                {
+                    const std::size_t slot = (z + i) % planes;
+                    if(!stored[slot])
+                    {
+                        continue;
+                    }
+                    const float        weight = mask.filter_z[i];
+                    const float* const plane  = ring[slot].data();
+                    for(std::size_t j = chunk; j < chunk_end; ++j)
+                    {
+                        output[j] += plane[j] * weight;
+                    }
+                }
+            }
+        };
+        parallel_for(plane_size, volume_convolution_z_chunk, num_threads, process_chunks);
+    };
+
+    // Waits for a pending read or write and accounts for the time spent waiting.
+    const auto wait = [&](std::future<bool>& pending)
+    {
+        HostClock clock;
+        clock.start_timer();
+        const bool result = pending.get();
+        clock.stop_timer();
+        statistics.wait_seconds += clock.get_elapsed_time();
+        return result;
+    };
+
+    std::future<bool> pending_read = std::async(std::launch::async, read_plane, -radius);
+    std::future<bool> pending_write;
+    bool              success = true;
+    for(std::ptrdiff_t q = -radius; q < depth + after && success; ++q)
+    {
+        success = wait(pending_read);
+        if(!success)
+        {
+            break;
+        }
+
+        HostClock clock;
+        clock.start_timer();
+        store_plane(q);
+        clock.stop_timer();
+        statistics.compute_seconds += clock.get_elapsed_time();
+
+        // The incoming buffer is free again, and the plane it replaced is no longer needed.
+        if(q + 1 < depth + after)
+        {
+            pending_read = std::async(std::launch::async, read_plane, q + 1);
+        }
+
+        // Plane q completes the input planes of output plane q - after.
+        const std::ptrdiff_t z = q - after;
+        if(z < 0)
+        {
+            continue;
+        }
+        clock.start_timer();
+        if(separable)
+        {
+            convolve_separable(z, output_planes[z % 2].data());
+        }
+        else
+        {
+            convolve_direct(z, output_planes[z % 2].data());
+        }
+        clock.stop_timer();
+        statistics.compute_seconds += clock.get_elapsed_time();
+
+        // Only one write is pending at a time, so the output buffer of the next plane is free
+        // once this one is written.
+        if(pending_write.valid())
+        {
+            success = wait(pending_write);
+        }
+        pending_write = std::async(std::launch::async, write_plane, z);
+    }
+    if(pending_read.valid())
+    {
+        pending_read.wait();
+    }
+    if(pending_write.valid())
+    {
+        success = wait(pending_write) && success;
+    }
+    return success;
+}
+
+/// \brief Multithreaded convolution of the volume of \p shape in \p input with \p mask and the
+/// boundary mode \p boundary by \p algorithm, which stores the result to \p output. The volume
+/// is streamed through \p convolution_volume_stream from memory, so that the working set is the
+/// ring of \p mask.width planes, rather than the volume, as the output planes are computed.
+inline void convolution_volume_cpu(float*                output,
+                                   const float*          input,
+                                   const VolumeShape&    shape,
+                                   const VolumeMask&     mask,
+                                   const VolumeAlgorithm algorithm,
+                                   const BoundaryMode    boundary,
+                                   const unsigned int    num_threads = 0,
+                                   const SimdLevel       simd_level  = get_host_simd_level())
+{
+    const GridRowReader reader = [&](const std::size_t first_row,
+                                     const std::size_t rows,
+                                     float*            destination,
+                                     const std::size_t stride)
+    {
+        for(std::size_t row = 0; row < rows; ++row)
+        {
+            const float* const source = input + (first_row + row) * shape.width;
+            std::copy(source, source + shape.width, destination + row * stride);
+        }
+        return true;
+    };
+    const GridRowWriter writer
+        = [&](const std::size_t first_row, const std::size_t rows, const float* source)
+    {
+        std::copy(source, source + rows * shape.width, output + first_row * shape.width);
+        return true;
+    };
+    StreamStatistics statistics;
+    convolution_volume_stream(reader,
+                              writer,
+                              shape,
+                              mask,
+                              algorithm,
+                              boundary,
+                              num_threads,
+                              simd_level,
+                              statistics);
+}
+
+#endif // _APPLICATIONS_CONVOLUTION_CONVOLUTION_VOLUME_HPP
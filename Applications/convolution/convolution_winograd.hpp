@@ -0,0 +1,647 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_CONVOLUTION_CONVOLUTION_WINOGRAD_HPP
+#define _APPLICATIONS_CONVOLUTION_CONVOLUTION_WINOGRAD_HPP
+
+#include "convolution_batched.hpp"
+#include "convolution_boundary.hpp"
+#include "convolution_simd.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// The Winograd kernels are written as plain loops over a group of tiles, which the compiler
+// vectorizes for the instruction set of the function they are inlined into. GCC and Clang are
+// told to inline them into the entry points compiled for each instruction set.
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define CONVOLUTION_FLATTEN
+#else
+    #define CONVOLUTION_FLATTEN __attribute__((flatten))
+#endif
+
+/// \brief Number of tiles that the Winograd kernels transform at once, one per vector lane.
+constexpr unsigned int winograd_lanes = 32;
+
+/// \brief Calls \p function with <tt>std::integral_constant<std::size_t, I></tt> for every I in
+/// \p Indices, so that I can be used in constant expressions.
+template<typename Function, std::size_t... Indices>
+void static_for(Function&& function, std::index_sequence<Indices...>)
+{
+    (function(std::integral_constant<std::size_t, Indices>{}), ...);
+}
+
+/// \brief Transform matrices of the Winograd minimal filtering algorithm F(m x m, r x r), which
+/// computes a tile of \p TileSize x \p TileSize (m x m) output elements of the convolution with
+/// a \p MaskWidth x \p MaskWidth (r x r) mask from <tt>alpha x alpha</tt> input elements, where
+/// <tt>alpha = m + r - 1</tt>, with only <tt>alpha * alpha</tt> multiplications:
+///
+/// <tt>Y = A^T [(G g G^T) * (B^T d B)] A</tt>,
+///
+/// where g is the mask, d the input tile and * the element-wise product. The matrices are
+/// derived with the Toom-Cook method from the interpolation points 0, 1, -1, 2, -2, 1/2, -1/2
+/// (as many as needed) and the point at infinity. For points \p p_j and
+/// <tt>f_j = prod_{l != j} (p_j - p_l)</tt>, row j of \p g holds <tt>p_j^k / f_j</tt>, row j of
+/// \p bt the coefficients of <tt>prod_{l != j} (x - p_l)</tt>, and column j of \p at the powers
+/// <tt>p_j^i</tt>. The point at infinity selects the highest coefficients. More points grow the
+/// magnitude of the coefficients, and with them the rounding errors.
+template<unsigned int TileSize, unsigned int MaskWidth>
+struct WinogradTransform
+{
+    static constexpr unsigned int alpha = TileSize + MaskWidth - 1;
+
+    std::array<std::array<double, alpha>, TileSize>  at{};
+    std::array<std::array<double, MaskWidth>, alpha> g{};
+    std::array<std::array<double, alpha>, alpha>     bt{};
+
+    constexpr WinogradTransform()
+    {
+        constexpr double all_points[] = {0.0, 1.0, -1.0, 2.0, -2.0, 0.5, -0.5};
+        static_assert(alpha - 1 <= sizeof(all_points) / sizeof(all_points[0]),
+                      "Not enough interpolation points for the tile and mask size.");
+
+        // Coefficients of the product of (x - p_l) over the points l other than skip.
+        constexpr unsigned int points     = alpha - 1;
+        const auto             polynomial = [&](const unsigned int skip)
+        {
+            std::array<double, alpha> coefficients{};
+            coefficients[0] = 1.0;
+            for(unsigned int l = 0; l < points; ++l)
+            {
+                if(l == skip)
+                {
+                    continue;
+                }
+                for(unsigned int k = alpha - 1; k > 0; --k)
+                {
+                    coefficients[k] = coefficients[k - 1] - all_points[l] * coefficients[k];
+                }
+                coefficients[0] = -all_points[l] * coefficients[0];
+            }
+            return coefficients;
+        };
+
+        for(unsigned int j = 0; j < points; ++j)
+        {
+            double factor = 1.0;
+            for(unsigned int l = 0; l < points; ++l)
+            {
+                factor *= l == j ? 1.0 : all_points[j] - all_points[l];
+            }
+            bt[j] = polynomial(j);
+
+            double power = 1.0;
+            for(unsigned int k = 0; k < std::max(TileSize, MaskWidth); ++k)
+            {
+                if(k < MaskWidth)
+                {
+                    g[j][k] = power / factor;
+                }
+                if(k < TileSize)
+                {
+                    at[k][j] = power;
+                }
+                power *= all_points[j];
+            }
+        }
+
+        // The point at infinity: the coefficients of the product over all points, and the
+        // highest coefficients of the mask and of the output.
+        bt[points]               = polynomial(points);
+        g[points][MaskWidth - 1] = 1.0;
+        at[TileSize - 1][points] = 1.0;
+    }
+};
+
+/// \brief Returns the transformed mask <tt>G g G^T</tt> of F(\p TileSize, \p MaskWidth) for the
+/// \p MaskWidth x \p MaskWidth \p mask g, computed in double precision.
+template<unsigned int TileSize, unsigned int MaskWidth>
+std::vector<float> winograd_transform_mask(const float* mask)
+{
+    constexpr WinogradTransform<TileSize, MaskWidth> transform;
+    constexpr unsigned int                           alpha = transform.alpha;
+
+    // G g, then (G g) G^T.
+    double gg[alpha][MaskWidth] = {};
+    for(unsigned int i = 0; i < alpha; ++i)
+    {
+        for(unsigned int j = 0; j < MaskWidth; ++j)
+        {
+            for(unsigned int k = 0; k < MaskWidth; ++k)
+            {
+                gg[i][j] += transform.g[i][k] * mask[k * MaskWidth + j];
+            }
+        }
+    }
+    std::vector<float> transformed(alpha * alpha);
+    for(unsigned int i = 0; i < alpha; ++i)
+    {
+        for(unsigned int j = 0; j < alpha; ++j)
+        {
+            double sum = 0.0;
+            for(unsigned int k = 0; k < MaskWidth; ++k)
+            {
+                sum += gg[i][k] * transform.g[j][k];
+            }
+            transformed[i * alpha + j] = static_cast<float>(sum);
+        }
+    }
+    return transformed;
+}
+
+/// \brief Stores <tt>sum_k matrix[Row][k] * vectors(k)</tt> to the \p winograd_lanes elements of
+/// \p result, where \p vectors(k) returns a pointer to the k-th vector. The coefficients are
+/// constants, so that the terms with zero coefficients are left out and those with coefficients
+/// of one need no multiplication.
+template<const auto& Matrix, std::size_t Row, std::size_t Columns, typename Vectors>
+void winograd_combine(float* result, const Vectors& vectors)
+{
+    for(unsigned int lane = 0; lane < winograd_lanes; ++lane)
+    {
+        float sum = 0.0f;
+        static_for(
+            [&](auto k)
+            {
+                constexpr float coefficient = static_cast<float>(Matrix[Row][k]);
+                if constexpr(coefficient != 0.0f)
+                {
+                    sum += coefficient * vectors(k)[lane];
+                }
+            },
+            std::make_index_sequence<Columns>());
+        result[lane] = sum;
+    }
+}
+
+/// \brief Transform matrices of F(\p TileSize, \p MaskWidth) and their transposes, as constants
+/// that \p winograd_combine can use.
+template<unsigned int TileSize, unsigned int MaskWidth>
+struct WinogradMatrices
+{
+    static constexpr WinogradTransform<TileSize, MaskWidth> transform{};
+    static constexpr unsigned int                           alpha = transform.alpha;
+
+    static constexpr auto bt = transform.bt;
+    static constexpr auto at = transform.at;
+};
+
+/// \brief Operands of a row of output tiles of a Winograd algorithm F(m x m, r x r), which can
+/// combine several input channels and filters like \p BatchedConvolutionShape: output channel f
+/// is the sum over the input channels c of their convolutions with mask (f, c).
+struct WinogradTileRow
+{
+    /// Output row y of channel f is stored from <tt>output + f * output_channel_stride +
+    /// y * output_stride</tt>, for <tt>y < rows</tt> (at most m) and the first \p columns
+    /// elements.
+    float*      output                = nullptr;
+    std::size_t output_stride         = 0;
+    std::size_t output_channel_stride = 0;
+    std::size_t rows                  = 0;
+    std::size_t columns               = 0;
+
+    /// Output element (y, x) of channel c reads the input elements <tt>input +
+    /// c * input_channel_stride + (y + i) * input_stride + x + j</tt>, for i and j below r. Each
+    /// channel must hold <tt>alpha = m + r - 1</tt> rows of <tt>ceiling_div(columns, m *
+    /// winograd_lanes) * m * winograd_lanes + alpha - 1</tt> elements, the elements beyond the
+    /// row only affect the output elements outside of it, which are not stored.
+    const float* input                = nullptr;
+    std::size_t  input_stride         = 0;
+    std::size_t  input_channel_stride = 0;
+
+    /// The <tt>alpha * alpha</tt> elements of transformed mask (f, c), see
+    /// \p winograd_transform_mask, start at <tt>(f * channels + c) * alpha * alpha</tt>.
+    const float* transformed_masks = nullptr;
+    std::size_t  channels          = 1;
+    std::size_t  filters           = 1;
+
+    /// Space for the transformed input tiles of all channels, <tt>channels * alpha * alpha *
+    /// winograd_lanes</tt> elements.
+    float* workspace = nullptr;
+};
+
+/// \brief Computes a row of output tiles of F(\p TileSize x \p TileSize, \p MaskWidth x
+/// \p MaskWidth) (see \p WinogradTileRow).
+///
+/// The tiles are processed in groups of \p winograd_lanes. The input rows of a group are split
+/// into \p TileSize phases of every \p TileSize-th element, so that element (i, j) of all tiles
+/// of the group is a contiguous vector, element i of the phase <tt>j % TileSize</tt> of row i
+/// onwards. The transforms are then sums of multiples of such vectors with constant
+/// coefficients. The transformed tiles of every channel are computed once, and multiplied with
+/// the transformed masks of every filter, whose products are summed up over the channels before
+/// the output transform. At the end, the output tiles are interleaved into the output rows.
+template<unsigned int TileSize, unsigned int MaskWidth>
+void winograd_tile_row(const WinogradTileRow& row)
+{
+    using Matrices                       = WinogradMatrices<TileSize, MaskWidth>;
+    constexpr std::size_t alpha          = Matrices::alpha;
+    constexpr std::size_t lanes          = winograd_lanes;
+    constexpr std::size_t phase_length   = lanes + (alpha - 1) / TileSize;
+    constexpr auto        alpha_indices  = std::make_index_sequence<alpha>();
+    constexpr auto        output_indices = std::make_index_sequence<TileSize>();
+
+    using TransformedTiles = float[alpha][alpha][lanes];
+    TransformedTiles* const transformed_input = reinterpret_cast<TransformedTiles*>(row.workspace);
+
+    const std::size_t tiles = ceiling_div(row.columns, TileSize);
+    for(std::size_t first_tile = 0; first_tile < tiles; first_tile += lanes)
+    {
+        const std::size_t first_column = first_tile * TileSize;
+
+        // B^T d B for the tiles of every channel.
+        for(std::size_t channel = 0; channel < row.channels; ++channel)
+        {
+            // Split the input rows of the group into phases.
+            float phases[alpha][TileSize][phase_length];
+            for(std::size_t i = 0; i < alpha; ++i)
+            {
+                const float* const input_row = row.input + channel * row.input_channel_stride
+                                               + i * row.input_stride + first_column;
+                for(std::size_t t = 0; t < phase_length; ++t)
+                {
+                    for(std::size_t phase = 0; phase < TileSize; ++phase)
+                    {
+                        phases[i][phase][t] = input_row[t * TileSize + phase];
+                    }
+                }
+            }
+
+            float partial[alpha][alpha][lanes];
+            static_for(
+                [&](auto i)
+                {
+                    for(std::size_t j = 0; j < alpha; ++j)
+                    {
+                        winograd_combine<Matrices::bt, i, alpha>(
+                            partial[i][j],
+                            [&](const std::size_t k)
+                            { return phases[k][j % TileSize] + j / TileSize; });
+                    }
+                },
+                alpha_indices);
+            for(std::size_t i = 0; i < alpha; ++i)
+            {
+                static_for(
+                    [&](auto j)
+                    {
+                        winograd_combine<Matrices::bt, j, alpha>(
+                            transformed_input[channel][i][j],
+                            [&](const std::size_t l) { return partial[i][l]; });
+                    },
+                    alpha_indices);
+            }
+        }
+
+        for(std::size_t filter = 0; filter < row.filters; ++filter)
+        {
+            // Sum of the element-wise products of the transformed tiles and masks.
+            float product[alpha][alpha][lanes] = {};
+            for(std::size_t channel = 0; channel < row.channels; ++channel)
+            {
+                const float* const transformed_mask
+                    = row.transformed_masks + (filter * row.channels + channel) * alpha * alpha;
+                for(std::size_t i = 0; i < alpha; ++i)
+                {
+                    for(std::size_t j = 0; j < alpha; ++j)
+                    {
+                        const float  weight = transformed_mask[i * alpha + j];
+                        const float* tiles  = transformed_input[channel][i][j];
+                        for(std::size_t lane = 0; lane < lanes; ++lane)
+                        {
+                            product[i][j][lane] += weight * tiles[lane];
+                        }
+                    }
+                }
+            }
+
+            // A^T M, then (A^T M) A.
+            float partial[TileSize][alpha][lanes];
+            static_for(
+                [&](auto i)
+                {
+                    for(std::size_t j = 0; j < alpha; ++j)
+                    {
+                        winograd_combine<Matrices::at, i, alpha>(partial[i][j],
+                                                                 [&](const std::size_t k)
+                                                                 { return product[k][j]; });
+                    }
+                },
+                output_indices);
+            float result[TileSize][TileSize][lanes];
+            for(std::size_t i = 0; i < TileSize; ++i)
+            {
+                static_for(
+                    [&](auto j)
+                    {
+                        winograd_combine<Matrices::at, j, alpha>(result[i][j],
+                                                                 [&](const std::size_t l)
+                                                                 { return partial[i][l]; });
+                    },
+                    output_indices);
+            }
+
+            // Interleave the output tiles into the output rows, except for the elements outside
+            // of the row.
+            const std::size_t group_columns
+                = std::min<std::size_t>(lanes * TileSize, row.columns - first_column);
+            for(std::size_t i = 0; i < row.rows; ++i)
+            {
+                float* const output_row = row.output + filter * row.output_channel_stride
+                                          + i * row.output_stride + first_column;
+                if(group_columns == lanes * TileSize)
+                {
+                    for(std::size_t t = 0; t < lanes; ++t)
+                    {
+                        for(std::size_t phase = 0; phase < TileSize; ++phase)
+                        {
+                            output_row[t * TileSize + phase] = result[i][phase][t];
+                        }
+                    }
+                }
+                else
+                {
+                    for(std::size_t x = 0; x < group_columns; ++x)
+                    {
+                        output_row[x] = result[i][x % TileSize][x / TileSize];
+                    }
+                }
+            }
+        }
+    }
+}
+
+#ifdef CONVOLUTION_X86_SIMD
+/// \brief \p winograd_tile_row vectorized for AVX2 by the compiler.
+template<unsigned int TileSize, unsigned int MaskWidth>
+CONVOLUTION_TARGET("avx2,fma")
+CONVOLUTION_FLATTEN void winograd_tile_row_avx2(const WinogradTileRow& row)
+{
+    winograd_tile_row<TileSize, MaskWidth>(row);
+}
+
+/// \brief \p winograd_tile_row vectorized for AVX-512 by the compiler.
+template<unsigned int TileSize, unsigned int MaskWidth>
+CONVOLUTION_TARGET("avx512f")
+CONVOLUTION_FLATTEN void winograd_tile_row_avx512(const WinogradTileRow& row)
+{
+    winograd_tile_row<TileSize, MaskWidth>(row);
+}
+#endif
+
+/// \brief Signature of \p winograd_tile_row.
+using WinogradTileRowFunction = void (*)(const WinogradTileRow& row);
+
+/// \brief Mask transform and tile row function of one Winograd algorithm F(m x m, r x r).
+struct WinogradAlgorithm
+{
+    unsigned int            tile_size                      = 0;
+    unsigned int            mask_width                     = 0;
+    std::vector<float> (*transform_mask)(const float* mask) = nullptr;
+    WinogradTileRowFunction tile_row                       = nullptr;
+};
+
+/// \brief Returns F(\p TileSize, \p MaskWidth) with the tile row function for \p level.
+template<unsigned int TileSize, unsigned int MaskWidth>
+WinogradAlgorithm make_winograd_algorithm(const SimdLevel level)
+{
+    WinogradAlgorithm algorithm{TileSize,
+                                MaskWidth,
+                                winograd_transform_mask<TileSize, MaskWidth>,
+                                winograd_tile_row<TileSize, MaskWidth>};
+#ifdef CONVOLUTION_X86_SIMD
+    if(level == SimdLevel::avx512)
+    {
+        algorithm.tile_row = winograd_tile_row_avx512<TileSize, MaskWidth>;
+    }
+    else if(level == SimdLevel::avx2)
+    {
+        algorithm.tile_row = winograd_tile_row_avx2<TileSize, MaskWidth>;
+    }
+#else
+    (void)level;
+#endif
+    return algorithm;
+}
+
+/// \brief Returns the Winograd algorithms for \p level, for output tiles of 2, 4 and 6 elements
+/// with 3 x 3 masks and of 2 and 4 elements with 5 x 5 masks. \p level must be supported by the
+/// host, which can be checked with \p get_host_simd_level.
+inline std::vector<WinogradAlgorithm> get_winograd_algorithms(const SimdLevel level)
+{
+    return {make_winograd_algorithm<2, 3>(level),
+            make_winograd_algorithm<4, 3>(level),
+            make_winograd_algorithm<6, 3>(level),
+            make_winograd_algorithm<2, 5>(level),
+            make_winograd_algorithm<4, 5>(level)};
+}
+
+/// \brief Returns whether there is a Winograd algorithm for output tiles of \p tile_size x
+/// \p tile_size elements and masks of \p mask_width x \p mask_width elements, and stores it to
+/// \p algorithm if so.
+inline bool find_winograd_algorithm(const unsigned int tile_size,
+                                    const unsigned int mask_width,
+                                    const SimdLevel    level,
+                                    WinogradAlgorithm& algorithm)
+{
+    for(const WinogradAlgorithm& candidate : get_winograd_algorithms(level))
+    {
+        if(candidate.tile_size == tile_size && candidate.mask_width == mask_width)
+        {
+            algorithm = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// \brief Multithreaded convolution of the grid of \p input with the \p mask_width x
+/// \p mask_width \p mask by the Winograd algorithm F(\p tile_size x \p tile_size, \p mask_width x
+/// \p mask_width), which must exist (see \p find_winograd_algorithm). \p output has the size of
+/// the grid.
+///
+/// The grid is split into rows of \p tile_size output rows, which are distributed across
+/// \p num_threads host threads (by default, \p get_default_host_threads()). The input rows of a
+/// row of tiles are copied into a buffer extended with the elements outside of the grid,
+/// derived with the boundary mode of \p input (see \p load_input_row), and as many further
+/// elements as the last tile needs. The tiles are transformed by the kernels vectorized for
+/// \p simd_level, which is lowered to the level supported by the host if necessary.
+///
+/// Each output tile needs <tt>alpha * alpha</tt> multiplications with the transformed mask,
+/// instead of <tt>tile_size^2 * mask_width^2</tt>, but many more additions for the transforms of
+/// the input and the output tiles. The results differ from those of the direct algorithm by
+/// rounding errors, which grow with the tile size.
+inline void convolution_winograd_cpu(float*                  output,
+                                     const ConvolutionInput& input,
+                                     const float*            mask,
+                                     const unsigned int      mask_width,
+                                     const unsigned int      tile_size,
+                                     const unsigned int      num_threads = 0,
+                                     const SimdLevel         simd_level  = get_host_simd_level())
+{
+    WinogradAlgorithm algorithm;
+    if(!find_winograd_algorithm(tile_size,
+                                mask_width,
+                                std::min(simd_level, get_host_simd_level()),
+                                algorithm))
+    {
+        return;
+    }
+    const std::vector<float> transformed_mask = algorithm.transform_mask(mask);
+
+    const std::size_t    width        = input.width;
+    const std::size_t    alpha        = tile_size + mask_width - 1;
+    const std::ptrdiff_t radius       = mask_width / 2;
+    const std::size_t    group_width  = tile_size * winograd_lanes;
+    const std::size_t    buffer_width = ceiling_div(width, group_width) * group_width + alpha - 1;
+    const std::size_t    tile_rows    = ceiling_div(input.height, tile_size);
+
+    parallel_for(tile_rows,
+                 1,
+                 num_threads,
+                 [&](const std::size_t tile_row_begin, const std::size_t tile_row_end)
+                 {
+                     std::vector<float> buffer(alpha * buffer_width);
+                     std::vector<float> workspace(alpha * alpha * winograd_lanes);
+                     for(std::size_t tile_row = tile_row_begin; tile_row < tile_row_end;
+                         ++tile_row)
+                     {
+                         const std::size_t first_row = tile_row * tile_size;
+                         for(std::size_t i = 0; i < alpha; ++i)
+                         {
+                             load_input_row(input,
+                                            static_cast<std::ptrdiff_t>(first_row + i) - radius,
+                                            -radius,
+                                            buffer_width,
+                                            buffer.data() + i * buffer_width);
+                         }
+
+                         WinogradTileRow row;
+                         row.output            = output + first_row * width;
+                         row.output_stride     = width;
+                         row.rows              = std::min<std::size_t>(tile_size,
+                                                                       input.height - first_row);
+                         row.columns           = width;
+                         row.input             = buffer.data();
+                         row.input_stride      = buffer_width;
+                         row.transformed_masks = transformed_mask.data();
+                         row.workspace         = workspace.data();
+                         algorithm.tile_row(row);
+                     }
+                 });
+}
+
+/// \brief Multithreaded batched convolution of \p input with the masks in \p filter_bank (see
+/// \p BatchedConvolutionShape) by the Winograd algorithm F(\p tile_size x \p tile_size,
+/// <tt>mask_width x mask_width</tt>), which must exist (see \p find_winograd_algorithm). The
+/// elements outside of the channels are derived with \p boundary.
+///
+/// The masks are transformed once. The rows of tiles of every image are distributed across
+/// \p num_threads host threads (by default, \p get_default_host_threads()), which transform the
+/// input tiles of every channel once for all filters, and sum up their products with the
+/// transformed masks over the channels before the output transform of every filter. So the
+/// transforms, which make the single grid Winograd algorithm slower than the direct one, are
+/// amortized over the filters and the channels respectively.
+inline void convolution_batched_winograd_cpu(float*                         output,
+                                             const float*                   input,
+                                             const float*                   filter_bank,
+                                             const BatchedConvolutionShape& shape,
+                                             const BoundaryMode             boundary,
+                                             const unsigned int             tile_size,
+                                             const unsigned int             num_threads = 0,
+                                             const SimdLevel simd_level = get_host_simd_level())
+{
+    WinogradAlgorithm algorithm;
+    if(!find_winograd_algorithm(tile_size,
+                                shape.mask_width,
+                                std::min(simd_level, get_host_simd_level()),
+                                algorithm))
+    {
+        return;
+    }
+
+    const std::size_t    plane_size  = shape.plane_size();
+    const std::size_t    mask_size   = shape.filter_size() / shape.channels;
+    const std::size_t    masks       = static_cast<std::size_t>(shape.filters) * shape.channels;
+    const std::size_t    alpha       = tile_size + shape.mask_width - 1;
+    const std::ptrdiff_t radius      = shape.mask_width / 2;
+    const std::size_t    group_width = tile_size * winograd_lanes;
+    const std::size_t    buffer_width
+        = ceiling_div(shape.width, group_width) * group_width + alpha - 1;
+    const std::size_t tile_rows = ceiling_div(shape.height, tile_size);
+
+    std::vector<float> transformed_masks(masks * alpha * alpha);
+    for(std::size_t i = 0; i < masks; ++i)
+    {
+        const std::vector<float> transformed_mask
+            = algorithm.transform_mask(filter_bank + i * mask_size);
+        std::copy(transformed_mask.begin(),
+                  transformed_mask.end(),
+                  transformed_masks.begin() + i * alpha * alpha);
+    }
+
+    const auto process_tile_rows = [&](const std::size_t item_begin, const std::size_t item_end)
+    {
+        std::vector<float> buffer(shape.channels * alpha * buffer_width);
+        std::vector<float> workspace(shape.channels * alpha * alpha * winograd_lanes);
+        for(std::size_t item = item_begin; item < item_end; ++item)
+        {
+            const std::size_t image     = item / tile_rows;
+            const std::size_t first_row = item % tile_rows * tile_size;
+            for(std::size_t channel = 0; channel < shape.channels; ++channel)
+            {
+                const float* const     channel_data
+                    = input + (image * shape.channels + channel) * plane_size;
+                const ConvolutionInput plane{channel_data, shape.width, shape.height, boundary};
+                for(std::size_t i = 0; i < alpha; ++i)
+                {
+                    load_input_row(plane,
+                                   static_cast<std::ptrdiff_t>(first_row + i) - radius,
+                                   -radius,
+                                   buffer_width,
+                                   buffer.data() + (channel * alpha + i) * buffer_width);
+                }
+            }
+
+            WinogradTileRow row;
+            row.output = output + image * shape.filters * plane_size + first_row * shape.width;
+            row.output_stride         = shape.width;
+            row.output_channel_stride = plane_size;
+            row.rows                  = std::min<std::size_t>(tile_size, shape.height - first_row);
+            row.columns               = shape.width;
+            row.input                 = buffer.data();
+            row.input_stride          = buffer_width;
+            row.input_channel_stride  = alpha * buffer_width;
+            row.transformed_masks     = transformed_masks.data();
+            row.channels              = shape.channels;
+            row.filters               = shape.filters;
+            row.workspace             = workspace.data();
+            algorithm.tile_row(row);
+        }
+    };
+    parallel_for(shape.batch * tile_rows, 1, num_threads, process_tile_rows);
+}
+
+#endif // _APPLICATIONS_CONVOLUTION_CONVOLUTION_WINOGRAD_HPP
@@ -0,0 +1,286 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_CLOSURE_HPP
+#define _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_CLOSURE_HPP
+
+#include "example_utils.hpp"
+#include "floyd_warshall_simd.hpp"
+#include "floyd_warshall_sparse.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// \brief Boolean reachability matrix of a graph, whose rows are stored as bitsets of 64-bit
+/// words: bit y of row x is set if node y can be reached from node x.
+struct ReachabilityMatrix
+{
+    unsigned int               nodes = 0;
+    std::size_t                words = 0;
+    std::vector<std::uint64_t> bits;
+
+    ReachabilityMatrix() = default;
+
+    explicit ReachabilityMatrix(const unsigned int nodes)
+        : nodes(nodes), words((nodes + 63) / 64), bits(static_cast<std::size_t>(nodes) * words)
+    {}
+
+    std::uint64_t* row(const unsigned int x)
+    {
+        return bits.data() + x * words;
+    }
+
+    const std::uint64_t* row(const unsigned int x) const
+    {
+        return bits.data() + x * words;
+    }
+
+    bool test(const unsigned int x, const unsigned int y) const
+    {
+        return (row(x)[y / 64] >> (y % 64)) & 1;
+    }
+
+    void set(const unsigned int x, const unsigned int y)
+    {
+        row(x)[y / 64] |= std::uint64_t{1} << (y % 64);
+    }
+
+    /// \brief Returns the number of pairs of nodes (x,y) such that y is reachable from x.
+    std::size_t count() const
+    {
+        std::size_t result = 0;
+        for(const std::uint64_t word : bits)
+        {
+            for(std::uint64_t remaining = word; remaining != 0; remaining &= remaining - 1)
+            {
+                ++result;
+            }
+        }
+        return result;
+    }
+};
+
+/// \brief Returns the reachability matrix of the edges of \p graph, in which every node can
+/// also reach itself, as it is at distance 0 in the distance matrix.
+inline ReachabilityMatrix make_reachability_matrix(const CsrGraph& graph)
+{
+    ReachabilityMatrix reachability(graph.nodes);
+    for(unsigned int x = 0; x < graph.nodes; ++x)
+    {
+        reachability.set(x, x);
+        for(std::size_t e = graph.row_offsets[x]; e < graph.row_offsets[x + 1]; ++e)
+        {
+            reachability.set(x, graph.targets[e]);
+        }
+    }
+    return reachability;
+}
+
+/// \brief Sets <tt>destination[i] |= sources[s][i]</tt> for the \p count rows in \p sources and
+/// the first \p words words of the rows. The words of \p destination are accumulated in groups
+/// of eight over all rows before they are stored.
+inline void or_rows_scalar(std::uint64_t*              destination,
+                           const std::uint64_t* const* sources,
+                           const unsigned int          count,
+                           const std::size_t           words)
+{
+    std::size_t i = 0;
+    for(; i + 8 <= words; i += 8)
+    {
+        std::uint64_t accumulator[8];
+        std::copy_n(destination + i, 8, accumulator);
+        for(unsigned int s = 0; s < count; ++s)
+        {
+            for(std::size_t j = 0; j < 8; ++j)
+            {
+                accumulator[j] |= sources[s][i + j];
+            }
+        }
+        std::copy_n(accumulator, 8, destination + i);
+    }
+    for(; i < words; ++i)
+    {
+        for(unsigned int s = 0; s < count; ++s)
+        {
+            destination[i] |= sources[s][i];
+        }
+    }
+}
+
+#ifdef FLOYD_WARSHALL_X86_SIMD
+/// \brief AVX2 version of \p or_rows_scalar, which keeps two vectors of \p destination in
+/// registers while the rows are ORed into them.
+FLOYD_WARSHALL_TARGET("avx2")
+inline void or_rows_avx2(std::uint64_t*              destination,
+                         const std::uint64_t* const* sources,
+                         const unsigned int          count,
+                         const std::size_t           words)
+{
+    std::size_t i = 0;
+    for(; i + 8 <= words; i += 8)
+    {
+        __m256i* const destination_i = reinterpret_cast<__m256i*>(destination + i);
+        __m256i        low           = _mm256_loadu_si256(destination_i);
+        __m256i        high          = _mm256_loadu_si256(destination_i + 1);
+        for(unsigned int s = 0; s < count; ++s)
+        {
+            const __m256i* const source_i = reinterpret_cast<const __m256i*>(sources[s] + i);
+            low  = _mm256_or_si256(low, _mm256_loadu_si256(source_i));
+            high = _mm256_or_si256(high, _mm256_loadu_si256(source_i + 1));
+        }
+        _mm256_storeu_si256(destination_i, low);
+        _mm256_storeu_si256(destination_i + 1, high);
+    }
+    for(; i < words; ++i)
+    {
+        for(unsigned int s = 0; s < count; ++s)
+        {
+            destination[i] |= sources[s][i];
+        }
+    }
+}
+
+/// \brief AVX-512 version of \p or_rows_scalar. The last partial vector of the rows is handled
+/// with masked loads and stores.
+FLOYD_WARSHALL_TARGET("avx512f")
+inline void or_rows_avx512(std::uint64_t*              destination,
+                           const std::uint64_t* const* sources,
+                           const unsigned int          count,
+                           const std::size_t           words)
+{
+    for(std::size_t i = 0; i < words; i += 8)
+    {
+        const __mmask8 active = words - i >= 8 ? __mmask8{0xFF}
+                                               : static_cast<__mmask8>((1u << (words - i)) - 1);
+
+        __m512i accumulator = _mm512_maskz_loadu_epi64(active, destination + i);
+        for(unsigned int s = 0; s < count; ++s)
+        {
+            accumulator
+                = _mm512_or_si512(accumulator, _mm512_maskz_loadu_epi64(active, sources[s] + i));
+        }
+        _mm512_mask_storeu_epi64(destination + i, active, accumulator);
+    }
+}
+#endif
+
+/// \brief Signature of the row ORs.
+using OrRowsFunction = void (*)(std::uint64_t*              destination,
+                                const std::uint64_t* const* sources,
+                                const unsigned int          count,
+                                const std::size_t           words);
+
+/// \brief Returns the row OR for \p level, or the scalar one if no vectorized version is
+/// available on this architecture. \p level must be supported by the host.
+inline OrRowsFunction get_or_rows_function(const SimdLevel level)
+{
+#ifdef FLOYD_WARSHALL_X86_SIMD
+    switch(level)
+    {
+        case SimdLevel::avx512: return or_rows_avx512;
+        case SimdLevel::avx2: return or_rows_avx2;
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    return or_rows_scalar;
+}
+
+/// \brief Computes the transitive closure of \p reachability in place with Warshall's
+/// algorithm: in step k, every row x that reaches k is replaced by its bitwise OR with row k,
+/// 64 nodes per operation.
+///
+/// The steps are applied in blocks of 64, the nodes of one word w of the rows. First, the steps
+/// of the block are applied to the 64 rows of the block in order, after which each of those rows
+/// already contains the rows of all nodes of the block that it reaches. Hence, the steps of the
+/// block applied to any other row x OR it with exactly the rows of the block whose bits are set
+/// in the closure of word w of row x, which only depends on word w of the rows of the block. The
+/// rows are processed in parallel by \p num_threads host threads (by default,
+/// \p get_default_host_threads()) with the row ORs for \p simd_level, which accumulate all rows
+/// of the block in registers before storing each part of row x, while the rows of the block stay
+/// in cache.
+inline void transitive_closure(ReachabilityMatrix& reachability,
+                               const unsigned int  num_threads = 0,
+                               const SimdLevel     simd_level  = get_host_simd_level())
+{
+    const OrRowsFunction or_rows
+        = get_or_rows_function(std::min(simd_level, get_host_simd_level()));
+
+    const unsigned int nodes = reachability.nodes;
+    const std::size_t  words = reachability.words;
+
+    for(std::size_t w = 0; w < words; ++w)
+    {
+        const unsigned int k_begin = static_cast<unsigned int>(w * 64);
+        const unsigned int k_count = std::min(nodes - k_begin, 64u);
+
+        // Rows of the block, in the order of the classic algorithm.
+        for(unsigned int k = 0; k < k_count; ++k)
+        {
+            const std::uint64_t* row_k = reachability.row(k_begin + k);
+            for(unsigned int x = 0; x < k_count; ++x)
+            {
+                std::uint64_t* row_x = reachability.row(k_begin + x);
+                if(x != k && ((row_x[w] >> k) & 1) != 0)
+                {
+                    or_rows(row_x, &row_k, 1, words);
+                }
+            }
+        }
+
+        // All other rows.
+        parallel_for(
+            nodes,
+            16,
+            num_threads,
+            [&](const std::size_t begin, const std::size_t end)
+            {
+                const std::uint64_t* sources[64];
+                for(std::size_t x = begin; x < end; ++x)
+                {
+                    if(x >= k_begin && x < k_begin + k_count)
+                    {
+                        continue;
+                    }
+
+                    std::uint64_t* row_x = reachability.row(static_cast<unsigned int>(x));
+                    std::uint64_t  mask  = row_x[w];
+                    unsigned int   count = 0;
+                    for(unsigned int k = 0; k < k_count; ++k)
+                    {
+                        if(((mask >> k) & 1) != 0)
+                        {
+                            sources[count] = reachability.row(k_begin + k);
+                            mask |= sources[count][w];
+                            ++count;
+                        }
+                    }
+                    or_rows(row_x, sources, count, words);
+                }
+            });
+    }
+}
+
+#endif // _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_CLOSURE_HPP
@@ -0,0 +1,238 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_CPU_HPP
+#define _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_CPU_HPP
+
+#include "example_utils.hpp"
+#include "floyd_warshall_simd.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/// \brief Row-major view of a part of a matrix, whose consecutive rows are \p stride elements
+/// apart.
+template<typename T>
+struct MatrixView
+{
+    T*          data   = nullptr;
+    std::size_t stride = 0;
+
+    T* row(const std::size_t index) const
+    {
+        return data + index * stride;
+    }
+};
+
+/// \brief Applies the steps <tt>k_begin <= k < k_begin + k_count</tt> of the Floyd-Warshall
+/// algorithm to a tile of \p rows x \p cols elements of the distance (\p distances) and
+/// \p next matrices. The elements of the views are indexed relative to the tile and to
+/// \p k_begin.
+///
+/// The distance from node x of the tile to node k before step k is read from
+/// <tt>d_x_k.row(x)[k - k_begin]</tt> and the distance from node k to node y of the tile from
+/// <tt>d_k_y.row(k - k_begin)[y]</tt>. These can view the tile itself when it contains the
+/// column or row k.
+///
+/// If \p column_snapshot is not null, column k of the tile, which must then be the column
+/// <tt>k - k_begin</tt> of the tile, is stored to <tt>column_snapshot.row(x)[k - k_begin]</tt>
+/// after step k, and analogously row k to <tt>row_snapshot.row(k - k_begin)[y]</tt>. Those are
+/// exactly the values that step k of the classic algorithm reads for the remaining tiles.
+///
+/// Each row of the tile is updated with \p min_plus_row.
+inline void floyd_warshall_tile(const MinPlusRowFunction        min_plus_row,
+                                const MatrixView<unsigned int>& distances,
+                                const MatrixView<unsigned int>& next,
+                                const unsigned int              rows,
+                                const unsigned int              cols,
+                                const unsigned int              k_begin,
+                                const unsigned int              k_count,
+                                const MatrixView<unsigned int>& d_x_k,
+                                const MatrixView<unsigned int>& d_k_y,
+                                const MatrixView<unsigned int>& column_snapshot = {},
+                                const MatrixView<unsigned int>& row_snapshot    = {})
+{
+    for(unsigned int k = 0; k < k_count; ++k)
+    {
+        const unsigned int* row_k = d_k_y.row(k);
+        for(unsigned int x = 0; x < rows; ++x)
+        {
+            min_plus_row(distances.row(x), next.row(x), row_k, d_x_k.row(x)[k], k_begin + k, cols);
+        }
+
+        if(column_snapshot.data != nullptr)
+        {
+            for(unsigned int x = 0; x < rows; ++x)
+            {
+                column_snapshot.row(x)[k] = distances.row(x)[k];
+            }
+        }
+        if(row_snapshot.data != nullptr)
+        {
+            std::copy(distances.row(k), distances.row(k) + cols, row_snapshot.row(k));
+        }
+    }
+}
+
+/// \brief Tiled multithreaded CPU implementation of the Floyd-Warshall algorithm.
+///
+/// The matrices are split into tiles of \p tile_size x \p tile_size elements, and the steps
+/// k of each block of \p tile_size nodes are applied in three phases: first to the diagonal
+/// tile, which only depends on itself, then to the remaining tiles of the same row and column
+/// of tiles, which only depend on themselves and the diagonal tile, and last to all other
+/// tiles, which only depend on the row and column tiles. The tiles of the second and third
+/// phases are processed in parallel by \p num_threads host threads (by default,
+/// \p get_default_host_threads()), and each tile stays in cache for a whole block of steps
+/// instead of the whole matrix being streamed from memory once per step.
+///
+/// While a block of steps is applied, the row and column tiles of the block record the values
+/// of row and column k right after step k, and the remaining tiles use those instead of the
+/// final values of the block. Hence every element is updated with exactly the same operands as
+/// in \p floyd_warshall_reference, and both \p adjacency_matrix and \p next_matrix are
+/// identical to its results, including the choice between equally short paths.
+///
+/// The rows of the tiles are updated with the min-plus kernel for \p simd_level, which is
+/// lowered to the level supported by the host if necessary. By default, the most capable one
+/// supported by the host is used.
+inline void floyd_warshall_blocked(unsigned int*      adjacency_matrix,
+                                   unsigned int*      next_matrix,
+                                   const unsigned int nodes,
+                                   unsigned int       tile_size,
+                                   const unsigned int num_threads = 0,
+                                   const SimdLevel    simd_level  = get_host_simd_level())
+{
+    const MinPlusRowFunction min_plus_row
+        = get_min_plus_row_function(std::min(simd_level, get_host_simd_level()));
+
+    tile_size                = std::max(1u, std::min(tile_size, nodes));
+    const unsigned int tiles = (nodes + tile_size - 1) / tile_size;
+
+    // Values of the column and the row of tiles of the current block after each of its steps.
+    std::vector<unsigned int> column_panel(static_cast<std::size_t>(nodes) * tile_size);
+    std::vector<unsigned int> row_panel(static_cast<std::size_t>(tile_size) * nodes);
+
+    // First row and column and size of a tile, and views of the tiles of the matrices and
+    // the parts of the panels that hold its rows or columns.
+    const auto begin = [&](const unsigned int tile) { return tile * tile_size; };
+    const auto size  = [&](const unsigned int tile)
+    { return std::min(nodes - begin(tile), tile_size); };
+    const auto tile_view = [&](unsigned int* matrix, unsigned int row, unsigned int col)
+    {
+        return MatrixView<unsigned int>{
+            matrix + static_cast<std::size_t>(begin(row)) * nodes + begin(col),
+            nodes};
+    };
+    const auto column_panel_view = [&](const unsigned int row)
+    {
+        return MatrixView<unsigned int>{
+            column_panel.data() + static_cast<std::size_t>(begin(row)) * tile_size,
+            tile_size};
+    };
+    const auto row_panel_view = [&](const unsigned int col)
+    { return MatrixView<unsigned int>{row_panel.data() + begin(col), nodes}; };
+
+    for(unsigned int block = 0; block < tiles; ++block)
+    {
+        const unsigned int k_begin = block * tile_size;
+        const unsigned int k_count = std::min(nodes - k_begin, tile_size);
+
+        // Phase 1: the diagonal tile depends only on itself.
+        const MatrixView<unsigned int> diagonal = tile_view(adjacency_matrix, block, block);
+        floyd_warshall_tile(min_plus_row,
+                            diagonal,
+                            tile_view(next_matrix, block, block),
+                            k_count,
+                            k_count,
+                            k_begin,
+                            k_count,
+                            diagonal,
+                            diagonal,
+                            column_panel_view(block),
+                            row_panel_view(block));
+
+        // Phase 2: the other tiles in the row and in the column of the diagonal tile. The first
+        // tiles - 1 work items are the row tiles, the rest are the column tiles.
+        const auto phase_2 = [&](const std::size_t item_begin, const std::size_t item_end)
+        {
+            for(std::size_t item = item_begin; item < item_end; ++item)
+            {
+                const unsigned int index = static_cast<unsigned int>(item % (tiles - 1));
+                const unsigned int other = index < block ? index : index + 1;
+                if(item < tiles - 1)
+                {
+                    const MatrixView<unsigned int> tile = tile_view(adjacency_matrix, block, other);
+                    floyd_warshall_tile(min_plus_row,
+                                        tile,
+                                        tile_view(next_matrix, block, other),
+                                        k_count,
+                                        size(other),
+                                        k_begin,
+                                        k_count,
+                                        column_panel_view(block),
+                                        tile,
+                                        {},
+                                        row_panel_view(other));
+                }
+                else
+                {
+                    const MatrixView<unsigned int> tile = tile_view(adjacency_matrix, other, block);
+                    floyd_warshall_tile(min_plus_row,
+                                        tile,
+                                        tile_view(next_matrix, other, block),
+                                        size(other),
+                                        k_count,
+                                        k_begin,
+                                        k_count,
+                                        tile,
+                                        row_panel_view(block),
+                                        column_panel_view(other));
+                }
+            }
+        };
+        parallel_for(2 * (tiles - 1), 1, num_threads, phase_2);
+
+        // Phase 3: all remaining tiles depend only on the row and column tiles.
+        const auto phase_3 = [&](const std::size_t item_begin, const std::size_t item_end)
+        {
+            for(std::size_t item = item_begin; item < item_end; ++item)
+            {
+                unsigned int row = static_cast<unsigned int>(item / (tiles - 1));
+                unsigned int col = static_cast<unsigned int>(item % (tiles - 1));
+                row += row >= block;
+                col += col >= block;
+                floyd_warshall_tile(min_plus_row,
+                                    tile_view(adjacency_matrix, row, col),
+                                    tile_view(next_matrix, row, col),
+                                    size(row),
+                                    size(col),
+                                    k_begin,
+                                    k_count,
+                                    column_panel_view(row),
+                                    row_panel_view(col));
+            }
+        };
+        parallel_for(static_cast<std::size_t>(tiles - 1) * (tiles - 1), 1, num_threads, phase_3);
+    }
+}
+
+#endif // _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_CPU_HPP
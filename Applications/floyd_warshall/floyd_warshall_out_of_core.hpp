@@ -0,0 +1,650 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_OUT_OF_CORE_HPP
+#define _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_OUT_OF_CORE_HPP
+
+#include "example_utils.hpp"
+#include "floyd_warshall_cpu.hpp"
+#include "floyd_warshall_simd.hpp"
+#include "floyd_warshall_sparse.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+/// \brief Amount of data transferred between a tile file and memory.
+struct TileTransferStatistics
+{
+    unsigned long long tile_loads    = 0;
+    unsigned long long bytes_read    = 0;
+    unsigned long long bytes_written = 0;
+
+    TileTransferStatistics& operator+=(const TileTransferStatistics& other)
+    {
+        tile_loads += other.tile_loads;
+        bytes_read += other.bytes_read;
+        bytes_written += other.bytes_written;
+        return *this;
+    }
+
+    TileTransferStatistics operator-(const TileTransferStatistics& other) const
+    {
+        return {tile_loads - other.tile_loads,
+                bytes_read - other.bytes_read,
+                bytes_written - other.bytes_written};
+    }
+};
+
+/// \brief Tile of the distance and next matrices mapped into memory.
+struct MappedTile
+{
+    MatrixView<unsigned int> distances;
+    MatrixView<unsigned int> next;
+};
+
+/// \brief Distance and next matrices of the Floyd-Warshall algorithm stored in a file, split
+/// into tiles of \p tile_size x \p tile_size elements. Each tile is stored contiguously, its
+/// distances followed by its next nodes, and is memory-mapped on demand. At most
+/// \p max_resident_tiles tiles are mapped at the same time; when another one is needed, the
+/// least recently used tile is unmapped and written back.
+///
+/// The operating system may keep unmapped pages cached, so the statistics count the data that
+/// the algorithm requests to be brought into and out of memory: a whole tile whenever a tile
+/// that holds data in the file is mapped, and again whenever a tile that was acquired for
+/// writing is unmapped. Tiles that have never been written back hold no data yet, and tiles
+/// that were only read need not be written back.
+class MappedTileMatrix
+{
+public:
+    MappedTileMatrix() = default;
+
+    MappedTileMatrix(const MappedTileMatrix&)            = delete;
+    MappedTileMatrix& operator=(const MappedTileMatrix&) = delete;
+
+    ~MappedTileMatrix()
+    {
+        close();
+    }
+
+    /// \brief Creates (or truncates) the file \p file_name for matrices of \p nodes nodes. The
+    /// tiles are not made larger than the matrices, so \p tile_size is clamped to \p nodes.
+    /// Prints an error message and returns false if the file cannot be created.
+    bool create(const std::string& file_name,
+                const unsigned int nodes,
+                const unsigned int tile_size,
+                const std::size_t  max_resident_tiles)
+    {
+        close();
+        this->nodes              = nodes;
+        this->tile_size          = std::max(1u, std::min(tile_size, nodes));
+        this->tiles              = (nodes + tile_size - 1) / tile_size;
+        this->max_resident_tiles = std::clamp<std::size_t>(max_resident_tiles,
+                                                           1,
+                                                           static_cast<std::size_t>(tiles) * tiles);
+
+        // Tiles are mapped separately, so they must start at multiples of the mapping
+        // granularity.
+        const std::size_t tile_bytes = 2 * tile_elements() * sizeof(unsigned int);
+        record_bytes = (tile_bytes + mapping_granularity() - 1) / mapping_granularity()
+                       * mapping_granularity();
+        const unsigned long long file_bytes
+            = static_cast<unsigned long long>(tiles) * tiles * record_bytes;
+
+#ifdef _WIN32
+        file = CreateFileA(file_name.c_str(),
+                           GENERIC_READ | GENERIC_WRITE,
+                           0,
+                           nullptr,
+                           CREATE_ALWAYS,
+                           FILE_ATTRIBUTE_NORMAL,
+                           nullptr);
+        LARGE_INTEGER size;
+        size.QuadPart = static_cast<LONGLONG>(file_bytes);
+        if(file == INVALID_HANDLE_VALUE || !SetFilePointerEx(file, size, nullptr, FILE_BEGIN)
+           || !SetEndOfFile(file))
+        {
+            return fail("Cannot create tile file \"" + file_name + "\".");
+        }
+        mapping = CreateFileMappingA(file,
+                                     nullptr,
+                                     PAGE_READWRITE,
+                                     static_cast<DWORD>(file_bytes >> 32),
+                                     static_cast<DWORD>(file_bytes),
+                                     nullptr);
+        if(mapping == nullptr)
+        {
+            return fail("Cannot map tile file \"" + file_name + "\".");
+        }
+#else
+        file = ::open(file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if(file < 0 || ::ftruncate(file, static_cast<off_t>(file_bytes)) != 0)
+        {
+            return fail("Cannot create tile file \"" + file_name + "\".");
+        }
+#endif
+        resident_tiles.clear();
+        lookup.assign(static_cast<std::size_t>(tiles) * tiles, resident_tiles.end());
+        stored_tiles.assign(static_cast<std::size_t>(tiles) * tiles, false);
+        return true;
+    }
+
+    /// \brief Unmaps all tiles and closes the file.
+    void close()
+    {
+        flush();
+#ifdef _WIN32
+        if(mapping != nullptr)
+        {
+            CloseHandle(mapping);
+            mapping = nullptr;
+        }
+        if(file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+        }
+#else
+        if(file >= 0)
+        {
+            ::close(file);
+            file = -1;
+        }
+#endif
+    }
+
+    /// \brief Maps the tile in row \p row and column \p col of tiles, if it is not mapped yet,
+    /// and marks it as the most recently used one. The returned views are valid until
+    /// \p max_resident_tiles other tiles are acquired. If \p write is true, the tile is marked
+    /// as modified, and is written back when it is unmapped.
+    MappedTile acquire(const unsigned int row, const unsigned int col, const bool write)
+    {
+        auto& entry = lookup[static_cast<std::size_t>(row) * tiles + col];
+        if(entry != resident_tiles.end())
+        {
+            resident_tiles.splice(resident_tiles.begin(), resident_tiles, entry);
+            entry->dirty = entry->dirty || write;
+            return make_tile(entry->data);
+        }
+
+        if(resident_tiles.size() == max_resident_tiles)
+        {
+            unmap(resident_tiles.back());
+            lookup[resident_tiles.back().index] = resident_tiles.end();
+            resident_tiles.pop_back();
+        }
+
+        const std::size_t index = static_cast<std::size_t>(row) * tiles + col;
+        resident_tiles.push_front({index, map(index), write});
+        entry = resident_tiles.begin();
+        ++transfers.tile_loads;
+        if(stored_tiles[index])
+        {
+            transfers.bytes_read += 2 * tile_elements() * sizeof(unsigned int);
+        }
+        return make_tile(entry->data);
+    }
+
+    /// \brief Unmaps all tiles, writing back the modified ones.
+    void flush()
+    {
+        for(const ResidentTile& tile : resident_tiles)
+        {
+            unmap(tile);
+            lookup[tile.index] = resident_tiles.end();
+        }
+        resident_tiles.clear();
+    }
+
+    /// \brief Returns the amount of data transferred since the file was created.
+    TileTransferStatistics statistics() const
+    {
+        return transfers;
+    }
+
+    unsigned int get_nodes() const
+    {
+        return nodes;
+    }
+
+    unsigned int get_tile_size() const
+    {
+        return tile_size;
+    }
+
+    unsigned int get_tiles() const
+    {
+        return tiles;
+    }
+
+    std::size_t get_max_resident_tiles() const
+    {
+        return max_resident_tiles;
+    }
+
+private:
+    struct ResidentTile
+    {
+        std::size_t   index;
+        unsigned int* data;
+        bool          dirty;
+    };
+
+    std::size_t tile_elements() const
+    {
+        return static_cast<std::size_t>(tile_size) * tile_size;
+    }
+
+    MappedTile make_tile(unsigned int* data) const
+    {
+        return {{data, tile_size}, {data + tile_elements(), tile_size}};
+    }
+
+    static std::size_t mapping_granularity()
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwAllocationGranularity;
+#else
+        return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    bool fail(const std::string& message)
+    {
+        std::cerr << message << std::endl;
+        close();
+        return false;
+    }
+
+    unsigned int* map(const std::size_t index) const
+    {
+        const unsigned long long offset = static_cast<unsigned long long>(index) * record_bytes;
+#ifdef _WIN32
+        void* data = MapViewOfFile(mapping,
+                                   FILE_MAP_ALL_ACCESS,
+                                   static_cast<DWORD>(offset >> 32),
+                                   static_cast<DWORD>(offset),
+                                   record_bytes);
+        if(data == nullptr)
+#else
+        // The whole tile is used right away, so fault it in at once instead of page by page.
+    #ifdef MAP_POPULATE
+        constexpr int flags = MAP_SHARED | MAP_POPULATE;
+    #else
+        constexpr int flags = MAP_SHARED;
+    #endif
+        void* data = ::mmap(nullptr,
+                            record_bytes,
+                            PROT_READ | PROT_WRITE,
+                            flags,
+                            file,
+                            static_cast<off_t>(offset));
+        if(data == MAP_FAILED)
+#endif
+        {
+            std::cerr << "Cannot map tile " << index << " of the tile file." << std::endl;
+            std::exit(error_exit_code);
+        }
+        return static_cast<unsigned int*>(data);
+    }
+
+    void unmap(const ResidentTile& tile)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(tile.data);
+#else
+        ::munmap(tile.data, record_bytes);
+#endif
+        if(tile.dirty)
+        {
+            transfers.bytes_written += 2 * tile_elements() * sizeof(unsigned int);
+            stored_tiles[tile.index] = true;
+        }
+    }
+
+    unsigned int nodes              = 0;
+    unsigned int tile_size          = 0;
+    unsigned int tiles              = 0;
+    std::size_t  max_resident_tiles = 0;
+    std::size_t  record_bytes       = 0;
+
+#ifdef _WIN32
+    HANDLE file    = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int file = -1;
+#endif
+
+    // Mapped tiles, from the most to the least recently used, and their position in that list.
+    std::list<ResidentTile>                       resident_tiles;
+    std::vector<std::list<ResidentTile>::iterator> lookup;
+    // Whether each tile has been written back, so that mapping it reads data from the file.
+    std::vector<bool>                              stored_tiles;
+    TileTransferStatistics                         transfers;
+};
+
+/// \brief Calls <tt>generator(row_begin, col_begin, rows, cols, tile)</tt> to write the input
+/// of each tile of \p matrix, where \p rows x \p cols is the part of the tile inside the matrix
+/// and \p row_begin and \p col_begin the first row and column of the tile. The elements outside
+/// the matrix are set to \p infinite_distance, so that they never shorten a path.
+template<typename Generator>
+void initialize_tiles(MappedTileMatrix& matrix, Generator&& generator)
+{
+    const unsigned int tiles     = matrix.get_tiles();
+    const unsigned int tile_size = matrix.get_tile_size();
+    const unsigned int nodes     = matrix.get_nodes();
+    for(unsigned int row = 0; row < tiles; ++row)
+    {
+        for(unsigned int col = 0; col < tiles; ++col)
+        {
+            const MappedTile tile = matrix.acquire(row, col, true);
+            for(unsigned int x = 0; x < tile_size; ++x)
+            {
+                std::fill_n(tile.distances.row(x), tile_size, infinite_distance);
+                std::fill_n(tile.next.row(x), tile_size, row * tile_size + x);
+            }
+            generator(row * tile_size,
+                      col * tile_size,
+                      std::min(nodes - row * tile_size, tile_size),
+                      std::min(nodes - col * tile_size, tile_size),
+                      tile);
+        }
+    }
+    matrix.flush();
+}
+
+/// \brief Copies the distance and next matrices stored in \p matrix to \p adjacency_matrix and
+/// \p next_matrix, which must have room for <tt>nodes * nodes</tt> elements.
+inline void read_tiles(MappedTileMatrix& matrix,
+                       unsigned int*     adjacency_matrix,
+                       unsigned int*     next_matrix)
+{
+    const unsigned int tiles     = matrix.get_tiles();
+    const unsigned int tile_size = matrix.get_tile_size();
+    const std::size_t  nodes     = matrix.get_nodes();
+    for(unsigned int row = 0; row < tiles; ++row)
+    {
+        for(unsigned int col = 0; col < tiles; ++col)
+        {
+            const MappedTile   tile = matrix.acquire(row, col, false);
+            const unsigned int rows = std::min<unsigned int>(nodes - row * tile_size, tile_size);
+            const unsigned int cols = std::min<unsigned int>(nodes - col * tile_size, tile_size);
+            for(unsigned int x = 0; x < rows; ++x)
+            {
+                const std::size_t offset = (row * tile_size + x) * nodes + col * tile_size;
+                std::copy_n(tile.distances.row(x), cols, adjacency_matrix + offset);
+                std::copy_n(tile.next.row(x), cols, next_matrix + offset);
+            }
+        }
+    }
+    matrix.flush();
+}
+
+/// \brief Data transferred by each phase of \p floyd_warshall_out_of_core and by the final
+/// write back of the tiles that remain mapped.
+struct OutOfCoreStatistics
+{
+    TileTransferStatistics phases[3];
+    TileTransferStatistics flush;
+};
+
+/// \brief Out-of-core version of \p floyd_warshall_blocked, for matrices stored in a
+/// \p MappedTileMatrix that need not fit in memory.
+///
+/// The three phases are applied to the (large) tiles of the file for each block of
+/// <tt>matrix.get_tile_size()</tt> steps, with the row and column panels of the block kept in
+/// memory. Every tile is therefore mapped once per block. The tiles of a phase are mapped in
+/// groups of at most <tt>matrix.get_max_resident_tiles()</tt> tiles, and each group is split
+/// into independent parts that are processed in parallel by \p num_threads host threads:
+/// column strips of the row tiles and row strips of the column tiles in the second phase, and
+/// subtiles of \p tile_size x \p tile_size elements in the third phase, each of which stays in
+/// cache for all steps of the block. The third phase processes the tiles of the row and column
+/// of the next block last, so that they are still mapped when the next block starts.
+///
+/// As in \p floyd_warshall_blocked, the results are identical to the ones of
+/// \p floyd_warshall_reference.
+inline void floyd_warshall_out_of_core(MappedTileMatrix&    matrix,
+                                       unsigned int         tile_size,
+                                       OutOfCoreStatistics& statistics,
+                                       const unsigned int   num_threads = 0,
+                                       const SimdLevel      simd_level  = get_host_simd_level())
+{
+    const MinPlusRowFunction min_plus_row
+        = get_min_plus_row_function(std::min(simd_level, get_host_simd_level()));
+
+    const unsigned int nodes          = matrix.get_nodes();
+    const unsigned int tiles          = matrix.get_tiles();
+    const unsigned int file_tile_size = matrix.get_tile_size();
+    const std::size_t  padded_nodes   = static_cast<std::size_t>(tiles) * file_tile_size;
+    const std::size_t  group_size     = matrix.get_max_resident_tiles();
+    tile_size                         = std::max(1u, std::min(tile_size, file_tile_size));
+    const unsigned int parts          = (file_tile_size + tile_size - 1) / tile_size;
+
+    // Values of the column and the row of tiles of the current block after each of its steps.
+    std::vector<unsigned int> column_panel(padded_nodes * file_tile_size);
+    std::vector<unsigned int> row_panel(static_cast<std::size_t>(file_tile_size) * padded_nodes);
+
+    const auto begin = [&](const unsigned int tile) { return tile * file_tile_size; };
+    const auto size  = [&](const unsigned int tile)
+    { return std::min(nodes - begin(tile), file_tile_size); };
+    // Size of a strip or subtile of a tile with the given extent.
+    const auto part_size = [&](const unsigned int extent, const unsigned int part)
+    {
+        const unsigned int part_begin = part * tile_size;
+        return part_begin < extent ? std::min(extent - part_begin, tile_size) : 0u;
+    };
+    const auto column_panel_view = [&](const std::size_t row)
+    {
+        return MatrixView<unsigned int>{column_panel.data() + row * file_tile_size,
+                                        file_tile_size};
+    };
+    const auto row_panel_view = [&](const std::size_t col)
+    { return MatrixView<unsigned int>{row_panel.data() + col, padded_nodes}; };
+    const auto offset = [](const MatrixView<unsigned int>& view, std::size_t row, std::size_t col)
+    { return MatrixView<unsigned int>{view.row(row) + col, view.stride}; };
+
+    // Maps the tiles in groups and calls process(tile, part) for every part of each of them.
+    const auto process_tiles
+        = [&](const std::vector<std::pair<unsigned int, unsigned int>>& tile_list,
+              const unsigned int                                       parts_per_tile,
+              const auto&                                              process)
+    {
+        std::vector<MappedTile> mapped(std::min(group_size, tile_list.size()));
+        for(std::size_t first = 0; first < tile_list.size(); first += group_size)
+        {
+            const std::size_t count = std::min(group_size, tile_list.size() - first);
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                mapped[i] = matrix.acquire(tile_list[first + i].first,
+                                           tile_list[first + i].second,
+                                           true);
+            }
+            parallel_for(count * parts_per_tile,
+                         1,
+                         num_threads,
+                         [&](const std::size_t item_begin, const std::size_t item_end)
+                         {
+                             for(std::size_t item = item_begin; item < item_end; ++item)
+                             {
+                                 const std::size_t i = item / parts_per_tile;
+                                 process(tile_list[first + i],
+                                         mapped[i],
+                                         static_cast<unsigned int>(item % parts_per_tile));
+                             }
+                         });
+        }
+    };
+
+    for(unsigned int block = 0; block < tiles; ++block)
+    {
+        const unsigned int k_begin = begin(block);
+        const unsigned int k_count = size(block);
+
+        // Phase 1: the diagonal tile depends only on itself.
+        TileTransferStatistics before   = matrix.statistics();
+        const MappedTile       diagonal = matrix.acquire(block, block, true);
+        floyd_warshall_tile(min_plus_row,
+                            diagonal.distances,
+                            diagonal.next,
+                            k_count,
+                            k_count,
+                            k_begin,
+                            k_count,
+                            diagonal.distances,
+                            diagonal.distances,
+                            column_panel_view(k_begin),
+                            row_panel_view(k_begin));
+        statistics.phases[0] += matrix.statistics() - before;
+
+        // Phase 2: the other tiles in the row and in the column of the diagonal tile. The
+        // columns of a row tile, and the rows of a column tile, are independent of each other.
+        before = matrix.statistics();
+        std::vector<std::pair<unsigned int, unsigned int>> tile_list;
+        for(unsigned int other = 0; other < tiles; ++other)
+        {
+            if(other != block)
+            {
+                tile_list.emplace_back(block, other);
+                tile_list.emplace_back(other, block);
+            }
+        }
+        process_tiles(
+            tile_list,
+            parts,
+            [&](const std::pair<unsigned int, unsigned int>& position,
+                const MappedTile&                            tile,
+                const unsigned int                           part)
+            {
+                const std::size_t part_begin = static_cast<std::size_t>(part) * tile_size;
+                if(position.first == block)
+                {
+                    const unsigned int cols = part_size(size(position.second), part);
+                    if(cols == 0)
+                    {
+                        return;
+                    }
+                    const MatrixView<unsigned int> strip = offset(tile.distances, 0, part_begin);
+                    floyd_warshall_tile(min_plus_row,
+                                        strip,
+                                        offset(tile.next, 0, part_begin),
+                                        k_count,
+                                        cols,
+                                        k_begin,
+                                        k_count,
+                                        column_panel_view(k_begin),
+                                        strip,
+                                        {},
+                                        row_panel_view(begin(position.second) + part_begin));
+                }
+                else
+                {
+                    const unsigned int rows = part_size(size(position.first), part);
+                    if(rows == 0)
+                    {
+                        return;
+                    }
+                    const MatrixView<unsigned int> strip = offset(tile.distances, part_begin, 0);
+                    floyd_warshall_tile(min_plus_row,
+                                        strip,
+                                        offset(tile.next, part_begin, 0),
+                                        rows,
+                                        k_count,
+                                        k_begin,
+                                        k_count,
+                                        strip,
+                                        row_panel_view(k_begin),
+                                        column_panel_view(begin(position.first) + part_begin));
+                }
+            });
+        statistics.phases[1] += matrix.statistics() - before;
+
+        // Phase 3: all remaining tiles depend only on the row and column panels. The tiles in
+        // the row and column of the next block go last.
+        before = matrix.statistics();
+        tile_list.clear();
+        std::vector<std::pair<unsigned int, unsigned int>> next_block_tiles;
+        for(unsigned int row = 0; row < tiles; ++row)
+        {
+            for(unsigned int col = 0; col < tiles; ++col)
+            {
+                if(row == block || col == block)
+                {
+                    continue;
+                }
+                (row == block + 1 || col == block + 1 ? next_block_tiles : tile_list)
+                    .emplace_back(row, col);
+            }
+        }
+        tile_list.insert(tile_list.end(), next_block_tiles.begin(), next_block_tiles.end());
+        process_tiles(
+            tile_list,
+            parts * parts,
+            [&](const std::pair<unsigned int, unsigned int>& position,
+                const MappedTile&                            tile,
+                const unsigned int                           part)
+            {
+                const unsigned int part_row = part / parts;
+                const unsigned int part_col = part % parts;
+                const unsigned int rows     = part_size(size(position.first), part_row);
+                const unsigned int cols     = part_size(size(position.second), part_col);
+                if(rows == 0 || cols == 0)
+                {
+                    return;
+                }
+                const std::size_t row_begin = static_cast<std::size_t>(part_row) * tile_size;
+                const std::size_t col_begin = static_cast<std::size_t>(part_col) * tile_size;
+                floyd_warshall_tile(min_plus_row,
+                                    offset(tile.distances, row_begin, col_begin),
+                                    offset(tile.next, row_begin, col_begin),
+                                    rows,
+                                    cols,
+                                    k_begin,
+                                    k_count,
+                                    column_panel_view(begin(position.first) + row_begin),
+                                    row_panel_view(begin(position.second) + col_begin));
+            });
+        statistics.phases[2] += matrix.statistics() - before;
+    }
+
+    const TileTransferStatistics before = matrix.statistics();
+    matrix.flush();
+    statistics.flush += matrix.statistics() - before;
+}
+
+#endif // _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_OUT_OF_CORE_HPP
@@ -0,0 +1,275 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_PATHS_HPP
+#define _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_PATHS_HPP
+
+#include "example_utils.hpp"
+#include "floyd_warshall_sparse.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/// \brief Next matrix of the shortest paths stored with 16-bit elements when the nodes fit in
+/// them, which halves its size, and with 32-bit elements otherwise.
+///
+/// This is a storage and query format only: the implementations of Floyd-Warshall compute the
+/// next matrix with 32-bit elements, from which it is encoded afterwards. The memory of keeping
+/// the paths for queries is halved once the 32-bit matrix is released, but the peak memory of
+/// computing them is not.
+class CompactNextMatrix
+{
+public:
+    CompactNextMatrix() = default;
+
+    /// \brief Encodes the \p nodes x \p nodes elements of \p next_matrix. If \p allow_compact is
+    /// false, 32-bit elements are used regardless of the number of nodes.
+    CompactNextMatrix(const std::vector<unsigned int>& next_matrix,
+                      const unsigned int               nodes,
+                      const bool                       allow_compact = true)
+        : nodes(nodes)
+    {
+        if(allow_compact && nodes <= std::numeric_limits<std::uint16_t>::max() + 1u)
+        {
+            compact_elements.assign(next_matrix.begin(), next_matrix.end());
+        }
+        else
+        {
+            wide_elements = next_matrix;
+        }
+    }
+
+    /// \brief Returns the next node of the shortest path from \p x to \p y.
+    unsigned int operator()(const unsigned int x, const unsigned int y) const
+    {
+        const std::size_t index = static_cast<std::size_t>(x) * nodes + y;
+        return is_compact() ? compact_elements[index] : wide_elements[index];
+    }
+
+    bool is_compact() const
+    {
+        return !compact_elements.empty();
+    }
+
+    unsigned int get_nodes() const
+    {
+        return nodes;
+    }
+
+    /// \brief Returns the size of the elements in bytes.
+    std::size_t bytes() const
+    {
+        return compact_elements.size() * sizeof(std::uint16_t)
+               + wide_elements.size() * sizeof(unsigned int);
+    }
+
+private:
+    unsigned int               nodes = 0;
+    std::vector<std::uint16_t> compact_elements;
+    std::vector<unsigned int>  wide_elements;
+};
+
+/// \brief Request for the shortest path from node \p source to node \p target.
+struct PathQuery
+{
+    unsigned int source;
+    unsigned int target;
+};
+
+/// \brief Shortest paths of a batch of queries. The nodes of path i, including its source and
+/// target, are <tt>nodes[offsets[i]]</tt> to <tt>nodes[offsets[i + 1] - 1]</tt>. The path of
+/// a query whose target cannot be reached is empty.
+struct PathBatch
+{
+    std::vector<std::size_t>  offsets;
+    std::vector<unsigned int> nodes;
+
+    std::size_t size() const
+    {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+};
+
+/// \brief Appends the nodes of the shortest path from \p source to \p target to \p path, using
+/// \p stack as scratch space. The next node k of the path from x to y is either x, if the path
+/// is the edge (x,y), or a node in between, in which case the path is the path from x to k
+/// followed by the path from k to y. Returns false if the path has more than \p next.get_nodes()
+/// nodes, or if more segments are expanded than such a path has, which means that \p next is
+/// not a valid next matrix. The latter bounds the expansion of cycles such as
+/// <tt>next(x,y) == y</tt> for <tt>x != y</tt>, which never append a node.
+inline bool append_path(const CompactNextMatrix&                            next,
+                        const unsigned int                                  source,
+                        const unsigned int                                  target,
+                        std::vector<std::pair<unsigned int, unsigned int>>& stack,
+                        std::vector<unsigned int>&                          path)
+{
+    const std::size_t path_begin = path.size();
+    path.push_back(source);
+    if(source == target)
+    {
+        return true;
+    }
+
+    // A path of at most n nodes has at most n - 1 edges, and its expansion is a binary tree with
+    // an edge at every leaf, so it has fewer than 2n segments.
+    const std::size_t max_segments = 2 * static_cast<std::size_t>(next.get_nodes());
+    std::size_t       segments     = 0;
+
+    // Segments of the path that remain to be expanded, the first one on top of the stack.
+    stack.assign(1, {source, target});
+    while(!stack.empty())
+    {
+        if(++segments > max_segments)
+        {
+            return false;
+        }
+        const std::pair<unsigned int, unsigned int> segment = stack.back();
+        stack.pop_back();
+        const unsigned int k = next(segment.first, segment.second);
+        if(k == segment.first)
+        {
+            path.push_back(segment.second);
+            if(path.size() - path_begin > next.get_nodes())
+            {
+                return false;
+            }
+        }
+        else
+        {
+            stack.emplace_back(k, segment.second);
+            stack.emplace_back(segment.first, k);
+        }
+    }
+    return true;
+}
+
+/// \brief Reconstructs the shortest paths of a batch of \p queries from the distance matrix
+/// \p adjacency_matrix, which tells which targets can be reached, and the next matrix \p next.
+///
+/// The queries are split into fixed blocks that are processed in parallel by \p num_threads
+/// host threads (by default, \p get_default_host_threads()), each one into its own buffer, so
+/// that the length of the paths does not need to be known in advance. The buffers are then
+/// concatenated in parallel. Paths that cannot be reconstructed because \p next is not valid
+/// are left empty.
+inline PathBatch reconstruct_paths(const std::vector<unsigned int>& adjacency_matrix,
+                                   const CompactNextMatrix&         next,
+                                   const std::vector<PathQuery>&    queries,
+                                   const unsigned int               num_threads = 0)
+{
+    // Number of queries of each block.
+    constexpr std::size_t block_size = 1024;
+
+    const std::size_t                      blocks = (queries.size() + block_size - 1) / block_size;
+    std::vector<std::vector<unsigned int>> block_nodes(blocks);
+
+    PathBatch batch;
+    batch.offsets.assign(queries.size() + 1, 0);
+    parallel_for(
+        blocks,
+        1,
+        num_threads,
+        [&](const std::size_t block_begin, const std::size_t block_end)
+        {
+            std::vector<std::pair<unsigned int, unsigned int>> stack;
+            for(std::size_t block = block_begin; block < block_end; ++block)
+            {
+                std::vector<unsigned int>& path = block_nodes[block];
+                const std::size_t          end = std::min(queries.size(), (block + 1) * block_size);
+                for(std::size_t i = block * block_size; i < end; ++i)
+                {
+                    const PathQuery&  query      = queries[i];
+                    const std::size_t path_begin = path.size();
+                    const std::size_t index
+                        = static_cast<std::size_t>(query.source) * next.get_nodes() + query.target;
+                    if(adjacency_matrix[index] < infinite_distance
+                       && !append_path(next, query.source, query.target, stack, path))
+                    {
+                        path.resize(path_begin);
+                    }
+                    // The length of the path for now, the offsets are computed afterwards.
+                    batch.offsets[i + 1] = path.size() - path_begin;
+                }
+            }
+        });
+
+    for(std::size_t i = 0; i < queries.size(); ++i)
+    {
+        batch.offsets[i + 1] += batch.offsets[i];
+    }
+    batch.nodes.resize(batch.offsets.back());
+    parallel_for(blocks,
+                 1,
+                 num_threads,
+                 [&](const std::size_t block_begin, const std::size_t block_end)
+                 {
+                     for(std::size_t block = block_begin; block < block_end; ++block)
+                     {
+                         std::copy(block_nodes[block].begin(),
+                                   block_nodes[block].end(),
+                                   batch.nodes.begin() + batch.offsets[block * block_size]);
+                     }
+                 });
+    return batch;
+}
+
+/// \brief Returns the number of paths of \p batch that do not answer their query in \p queries:
+/// paths to reachable targets must start and end at the right nodes and their edges in the
+/// input distance matrix \p input_adjacency_matrix must add up to the shortest distance in
+/// \p adjacency_matrix, and paths to unreachable targets must be empty.
+inline std::size_t count_invalid_paths(const std::vector<unsigned int>& input_adjacency_matrix,
+                                       const std::vector<unsigned int>& adjacency_matrix,
+                                       const std::size_t                nodes,
+                                       const std::vector<PathQuery>&    queries,
+                                       const PathBatch&                 batch)
+{
+    std::size_t errors = 0;
+    for(std::size_t i = 0; i < queries.size(); ++i)
+    {
+        const unsigned int* path   = batch.nodes.data() + batch.offsets[i];
+        const std::size_t   length = batch.offsets[i + 1] - batch.offsets[i];
+        const unsigned int  d_x_y
+            = adjacency_matrix[queries[i].source * nodes + queries[i].target];
+        if(d_x_y >= infinite_distance)
+        {
+            errors += length != 0;
+            continue;
+        }
+        if(length == 0 || path[0] != queries[i].source || path[length - 1] != queries[i].target)
+        {
+            ++errors;
+            continue;
+        }
+        unsigned long long path_distance = 0;
+        for(std::size_t j = 1; j < length; ++j)
+        {
+            path_distance += input_adjacency_matrix[path[j - 1] * nodes + path[j]];
+        }
+        errors += path_distance != d_x_y;
+    }
+    return errors;
+}
+
+#endif // _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_PATHS_HPP
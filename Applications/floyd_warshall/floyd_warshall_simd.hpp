@@ -0,0 +1,161 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_SIMD_HPP
+#define _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_SIMD_HPP
+
+#include "example_utils.hpp"
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+
+    #define FLOYD_WARSHALL_X86_SIMD
+    // GCC and Clang only allow intrinsics in functions compiled for the corresponding instruction
+    // set, while MSVC allows them anywhere.
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define FLOYD_WARSHALL_TARGET(isa)
+    #else
+        #define FLOYD_WARSHALL_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#endif
+
+/// \brief Min-plus update of \p count consecutive elements of a row x of the distance
+/// (\p distances) and next (\p next) matrices with step k of the Floyd-Warshall algorithm:
+/// element y is replaced by <tt>d_x_k + row_k[y]</tt> if the latter is shorter, in which case
+/// the next node of the path becomes k.
+inline void min_plus_row_scalar(unsigned int*       distances,
+                                unsigned int*       next,
+                                const unsigned int* row_k,
+                                const unsigned int  d_x_k,
+                                const unsigned int  k,
+                                const std::size_t   count)
+{
+    for(std::size_t y = 0; y < count; ++y)
+    {
+        // Shortest distance from node x to node y passing through node v_k.
+        const unsigned int d_x_k_y = d_x_k + row_k[y];
+        if(d_x_k_y < distances[y])
+        {
+            distances[y] = d_x_k_y;
+            next[y]      = k;
+        }
+    }
+}
+
+#ifdef FLOYD_WARSHALL_X86_SIMD
+/// \brief AVX2 version of \p min_plus_row_scalar. The unsigned comparison is derived from the
+/// element-wise minimum, which differs from the current distance exactly when the path through
+/// node k is shorter, and selects between the current next node and k with a blend. Vectors in
+/// which no distance changes, the common case in later steps, are not written back.
+FLOYD_WARSHALL_TARGET("avx2")
+inline void min_plus_row_avx2(unsigned int*       distances,
+                              unsigned int*       next,
+                              const unsigned int* row_k,
+                              const unsigned int  d_x_k,
+                              const unsigned int  k,
+                              const std::size_t   count)
+{
+    const __m256i d_x_k_vector = _mm256_set1_epi32(static_cast<int>(d_x_k));
+    const __m256i k_vector     = _mm256_set1_epi32(static_cast<int>(k));
+
+    std::size_t y = 0;
+    for(; y + 8 <= count; y += 8)
+    {
+        __m256i* const       distances_y = reinterpret_cast<__m256i*>(distances + y);
+        __m256i* const       next_y      = reinterpret_cast<__m256i*>(next + y);
+        const __m256i* const row_k_y     = reinterpret_cast<const __m256i*>(row_k + y);
+
+        const __m256i d_x_y   = _mm256_loadu_si256(distances_y);
+        const __m256i d_x_k_y = _mm256_add_epi32(d_x_k_vector, _mm256_loadu_si256(row_k_y));
+        const __m256i minimum = _mm256_min_epu32(d_x_k_y, d_x_y);
+        const __m256i kept    = _mm256_cmpeq_epi32(minimum, d_x_y);
+
+        if(_mm256_movemask_epi8(kept) != -1)
+        {
+            const __m256i next_kept = _mm256_loadu_si256(next_y);
+            _mm256_storeu_si256(distances_y, minimum);
+            _mm256_storeu_si256(next_y, _mm256_blendv_epi8(k_vector, next_kept, kept));
+        }
+    }
+    min_plus_row_scalar(distances + y, next + y, row_k + y, d_x_k, k, count - y);
+}
+
+/// \brief AVX-512 version of \p min_plus_row_scalar. The comparison produces a mask with which
+/// only the shorter distances and their next nodes are stored. The last partial vector of the
+/// row is handled with masked loads instead of a scalar loop.
+FLOYD_WARSHALL_TARGET("avx512f")
+inline void min_plus_row_avx512(unsigned int*       distances,
+                                unsigned int*       next,
+                                const unsigned int* row_k,
+                                const unsigned int  d_x_k,
+                                const unsigned int  k,
+                                const std::size_t   count)
+{
+    const __m512i d_x_k_vector = _mm512_set1_epi32(static_cast<int>(d_x_k));
+    const __m512i k_vector     = _mm512_set1_epi32(static_cast<int>(k));
+
+    for(std::size_t y = 0; y < count; y += 16)
+    {
+        const __mmask16 active
+            = count - y >= 16 ? __mmask16{0xFFFF}
+                              : static_cast<__mmask16>((1u << (count - y)) - 1);
+
+        const __m512i   d_x_y   = _mm512_maskz_loadu_epi32(active, distances + y);
+        const __m512i   d_x_k_y = _mm512_add_epi32(d_x_k_vector,
+                                                 _mm512_maskz_loadu_epi32(active, row_k + y));
+        const __mmask16 shorter = _mm512_mask_cmplt_epu32_mask(active, d_x_k_y, d_x_y);
+
+        _mm512_mask_storeu_epi32(distances + y, shorter, d_x_k_y);
+        _mm512_mask_storeu_epi32(next + y, shorter, k_vector);
+    }
+}
+#endif
+
+/// \brief Signature of the min-plus row updates.
+using MinPlusRowFunction = void (*)(unsigned int*       distances,
+                                    unsigned int*       next,
+                                    const unsigned int* row_k,
+                                    const unsigned int  d_x_k,
+                                    const unsigned int  k,
+                                    const std::size_t   count);
+
+/// \brief Returns the min-plus row update for \p level, or the scalar one if no vectorized
+/// version is available on this architecture. \p level must be supported by the host, which
+/// can be checked with \p get_host_simd_level.
+inline MinPlusRowFunction get_min_plus_row_function(const SimdLevel level)
+{
+#ifdef FLOYD_WARSHALL_X86_SIMD
+    switch(level)
+    {
+        case SimdLevel::avx512: return min_plus_row_avx512;
+        case SimdLevel::avx2: return min_plus_row_avx2;
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    return min_plus_row_scalar;
+}
+
+#endif // _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_SIMD_HPP
@@ -0,0 +1,451 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_SPARSE_HPP
+#define _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_SPARSE_HPP
+
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/// \brief Distance between two nodes without a path between them. Twice this value still fits
+/// in an unsigned int, so adding two distances in the Floyd-Warshall step never wraps around.
+constexpr unsigned int infinite_distance = std::numeric_limits<unsigned int>::max() / 2;
+
+/// \brief Directed and weighted graph in compressed sparse row (CSR) format. The outgoing edges
+/// of node x are the entries <tt>row_offsets[x] <= e < row_offsets[x + 1]</tt> of \p targets and
+/// \p weights.
+struct CsrGraph
+{
+    unsigned int              nodes = 0;
+    std::vector<std::size_t>  row_offsets;
+    std::vector<unsigned int> targets;
+    std::vector<unsigned int> weights;
+
+    std::size_t edges() const
+    {
+        return targets.size();
+    }
+
+    /// \brief Fraction of the possible edges between distinct nodes that are present.
+    double density() const
+    {
+        return nodes < 2 ? 1.0 : static_cast<double>(edges()) / nodes / (nodes - 1);
+    }
+};
+
+/// \brief Edge of a graph, as read from a file.
+struct GraphEdge
+{
+    unsigned int source;
+    unsigned int target;
+    unsigned int weight;
+};
+
+/// \brief Builds a \p CsrGraph with \p nodes nodes from a list of edges. Self loops are dropped,
+/// as every node is at distance 0 from itself, and of parallel edges only the lightest is kept.
+inline CsrGraph make_csr_graph(const unsigned int nodes, std::vector<GraphEdge> edges)
+{
+    std::sort(edges.begin(),
+              edges.end(),
+              [](const GraphEdge& lhs, const GraphEdge& rhs)
+              {
+                  return std::tie(lhs.source, lhs.target, lhs.weight)
+                         < std::tie(rhs.source, rhs.target, rhs.weight);
+              });
+
+    CsrGraph graph;
+    graph.nodes = nodes;
+    graph.row_offsets.assign(nodes + 1, 0);
+    for(std::size_t e = 0; e < edges.size(); ++e)
+    {
+        const GraphEdge& edge = edges[e];
+        if(edge.source == edge.target
+           || (e > 0 && edges[e - 1].source == edge.source && edges[e - 1].target == edge.target))
+        {
+            continue;
+        }
+        graph.targets.push_back(edge.target);
+        graph.weights.push_back(edge.weight);
+        ++graph.row_offsets[edge.source + 1];
+    }
+    std::partial_sum(graph.row_offsets.begin(), graph.row_offsets.end(), graph.row_offsets.begin());
+    return graph;
+}
+
+/// \brief Loads a graph from \p file_name into \p graph. Two formats are accepted, and can be
+/// told apart line by line:
+/// - Edge lists, with one edge "source target [weight]" per line. Nodes are numbered from 0,
+///   the number of nodes is the largest node index plus one and the weight defaults to 1.
+///   Lines starting with '#' or '%' are comments.
+/// - DIMACS shortest path files (.gr), with a problem line "p sp nodes edges" followed by
+///   arc lines "a source target weight". Nodes are numbered from 1. Lines starting with 'c'
+///   are comments.
+///
+/// Weights must be non-negative integers smaller than \p infinite_distance. If the file cannot
+/// be read, an error is printed to the standard error output and false is returned.
+inline bool load_csr_graph(const std::string& file_name, CsrGraph& graph)
+{
+    std::ifstream file(file_name);
+    if(!file)
+    {
+        std::cerr << "Cannot open graph file \"" << file_name << "\"." << std::endl;
+        return false;
+    }
+
+    std::vector<GraphEdge> edges;
+    unsigned long long     nodes         = 0;
+    bool                   dimacs_header = false;
+    std::string            line;
+    for(std::size_t line_number = 1; std::getline(file, line); ++line_number)
+    {
+        std::istringstream line_stream(line);
+        std::string        first;
+        if(!(line_stream >> first) || first[0] == '#' || first[0] == '%' || first == "c")
+        {
+            continue;
+        }
+
+        const auto fail = [&](const std::string& reason)
+        {
+            std::cerr << file_name << ":" << line_number << ": " << reason << std::endl;
+            return false;
+        };
+
+        if(first == "p")
+        {
+            std::string       problem;
+            unsigned long long edge_count;
+            if(!(line_stream >> problem >> nodes >> edge_count) || nodes == 0)
+            {
+                return fail("invalid problem line, expected \"p sp nodes edges\".");
+            }
+            dimacs_header = true;
+            edges.reserve(edge_count);
+            continue;
+        }
+
+        // Edge lines, "a source target weight" in DIMACS files and "source target [weight]"
+        // in edge lists.
+        const bool         dimacs = first == "a";
+        long long          source = 0, target = 0, weight = 1;
+        std::istringstream numbers(dimacs ? line.substr(line.find('a') + 1) : line);
+        if(!(numbers >> source >> target) || (!(numbers >> weight) && dimacs))
+        {
+            return fail("invalid edge, expected \"" + std::string(dimacs ? "a " : "")
+                        + "source target" + (dimacs ? " weight" : " [weight]") + "\".");
+        }
+        if(dimacs && !dimacs_header)
+        {
+            return fail("arc before the problem line.");
+        }
+        source -= dimacs;
+        target -= dimacs;
+        if(source < 0 || target < 0
+           || (dimacs && (static_cast<unsigned long long>(source) >= nodes
+                          || static_cast<unsigned long long>(target) >= nodes)))
+        {
+            return fail("node index out of range.");
+        }
+        if(weight < 0 || weight >= static_cast<long long>(infinite_distance))
+        {
+            return fail("weights must be non-negative and smaller than "
+                        + std::to_string(infinite_distance) + ".");
+        }
+        if(!dimacs)
+        {
+            nodes = std::max(nodes, static_cast<unsigned long long>(std::max(source, target)) + 1);
+        }
+        edges.push_back({static_cast<unsigned int>(source),
+                         static_cast<unsigned int>(target),
+                         static_cast<unsigned int>(weight)});
+    }
+
+    if(nodes == 0 || nodes > std::numeric_limits<unsigned int>::max())
+    {
+        std::cerr << "Graph file \"" << file_name << "\" contains no valid graph." << std::endl;
+        return false;
+    }
+    graph = make_csr_graph(static_cast<unsigned int>(nodes), std::move(edges));
+    return true;
+}
+
+/// \brief Generates a random graph in which every node has \p degree outgoing edges to distinct
+/// random nodes, with weights in <tt>[1, max_weight]</tt>.
+inline CsrGraph make_random_csr_graph(const unsigned int nodes,
+                                      unsigned int       degree,
+                                      const unsigned int max_weight,
+                                      const unsigned int seed = 0)
+{
+    degree = std::min(degree, nodes - 1);
+
+    std::mt19937                                generator(seed);
+    std::uniform_int_distribution<unsigned int> target_distribution(0, nodes - 2);
+    std::uniform_int_distribution<unsigned int> weight_distribution(1, max_weight);
+
+    std::vector<GraphEdge>    edges;
+    std::vector<unsigned int> targets;
+    edges.reserve(static_cast<std::size_t>(nodes) * degree);
+    for(unsigned int x = 0; x < nodes; ++x)
+    {
+        targets.clear();
+        while(targets.size() < degree)
+        {
+            // Skip node x itself to avoid self loops.
+            unsigned int y = target_distribution(generator);
+            y += y >= x;
+            if(std::find(targets.begin(), targets.end(), y) == targets.end())
+            {
+                targets.push_back(y);
+                edges.push_back({x, y, weight_distribution(generator)});
+            }
+        }
+    }
+    return make_csr_graph(nodes, std::move(edges));
+}
+
+/// \brief Writes the distance (\p adjacency_matrix) and \p next_matrix input matrices of the
+/// Floyd-Warshall algorithm for \p graph: the weight of edge (x,y) or \p infinite_distance if
+/// there is none, and node x as the next node of every path from x.
+inline void csr_to_adjacency_matrix(const CsrGraph&            graph,
+                                    std::vector<unsigned int>& adjacency_matrix,
+                                    std::vector<unsigned int>& next_matrix)
+{
+    const std::size_t nodes = graph.nodes;
+    adjacency_matrix.assign(nodes * nodes, infinite_distance);
+    next_matrix.resize(nodes * nodes);
+    for(std::size_t x = 0; x < nodes; ++x)
+    {
+        std::fill_n(next_matrix.begin() + x * nodes, nodes, static_cast<unsigned int>(x));
+        adjacency_matrix[x * nodes + x] = 0;
+        for(std::size_t e = graph.row_offsets[x]; e < graph.row_offsets[x + 1]; ++e)
+        {
+            adjacency_matrix[x * nodes + graph.targets[e]] = graph.weights[e];
+        }
+    }
+}
+
+/// \brief Builds the \p CsrGraph with the edges of the distance matrix \p adjacency_matrix that
+/// are not on its diagonal and not \p infinite_distance.
+inline CsrGraph csr_from_adjacency_matrix(const std::vector<unsigned int>& adjacency_matrix,
+                                          const unsigned int               nodes)
+{
+    CsrGraph graph;
+    graph.nodes = nodes;
+    graph.row_offsets.assign(nodes + 1, 0);
+    for(std::size_t x = 0; x < nodes; ++x)
+    {
+        for(std::size_t y = 0; y < nodes; ++y)
+        {
+            const unsigned int weight = adjacency_matrix[x * nodes + y];
+            if(x != y && weight < infinite_distance)
+            {
+                graph.targets.push_back(static_cast<unsigned int>(y));
+                graph.weights.push_back(weight);
+            }
+        }
+        graph.row_offsets[x + 1] = graph.targets.size();
+    }
+    return graph;
+}
+
+/// \brief Computes the shortest paths between all pairs of nodes of \p graph with Dijkstra's
+/// algorithm from every source node, and writes them in the format of the Floyd-Warshall
+/// algorithm: \p adjacency_matrix holds the distances (\p infinite_distance for unreachable
+/// nodes), and <tt>next_matrix[x * nodes + y]</tt> is the node preceding y on the shortest path
+/// from x, or x if the path is the edge (x,y) itself (or there is no path).
+///
+/// The source nodes are distributed among \p num_threads host threads (by default,
+/// \p get_default_host_threads()). Ties between equally short paths are broken by the number of
+/// edges, so that the last edge (p,y) of the path chosen for (x,y) is also the path chosen for
+/// (p,y). Hence, the paths can be reconstructed from \p next_matrix in the same way as the ones
+/// computed by Floyd-Warshall. Returns false if some shortest distance does not fit below
+/// \p infinite_distance. Longer paths to nodes that also have a shorter one do not matter.
+inline bool dijkstra_all_pairs(const CsrGraph&            graph,
+                               std::vector<unsigned int>& adjacency_matrix,
+                               std::vector<unsigned int>& next_matrix,
+                               const unsigned int         num_threads = 0)
+{
+    const std::size_t nodes = graph.nodes;
+    adjacency_matrix.resize(nodes * nodes);
+    next_matrix.resize(nodes * nodes);
+
+    // The priority of a node is its distance in the upper and its number of edges in the lower
+    // 32 bits, so that comparing priorities compares distances first.
+    using Priority                      = unsigned long long;
+    constexpr Priority unreached        = std::numeric_limits<Priority>::max();
+    std::atomic<bool>  distance_overflow{false};
+
+    parallel_for(
+        nodes,
+        1,
+        num_threads,
+        [&](const std::size_t begin, const std::size_t end)
+        {
+            using QueueEntry = std::pair<Priority, unsigned int>;
+            std::vector<Priority>     priorities(nodes);
+            std::vector<unsigned int> predecessors(nodes);
+            std::vector<bool>         overflowed(nodes);
+            std::vector<QueueEntry>   heap_storage;
+            std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>
+                queue(std::greater<QueueEntry>(), std::move(heap_storage));
+
+            for(std::size_t source = begin; source < end; ++source)
+            {
+                std::fill(priorities.begin(), priorities.end(), unreached);
+                std::fill(predecessors.begin(), predecessors.end(), source);
+                std::fill(overflowed.begin(), overflowed.end(), false);
+                priorities[source] = 0;
+                queue.push({0, static_cast<unsigned int>(source)});
+
+                while(!queue.empty())
+                {
+                    const QueueEntry entry = queue.top();
+                    queue.pop();
+                    const unsigned int x = entry.second;
+                    // Skip entries of nodes that were reached by a shorter path later on.
+                    if(entry.first != priorities[x])
+                    {
+                        continue;
+                    }
+                    const Priority distance = entry.first >> 32;
+                    const Priority edges    = (entry.first & 0xFFFFFFFFull) + 1;
+                    for(std::size_t e = graph.row_offsets[x]; e < graph.row_offsets[x + 1]; ++e)
+                    {
+                        const unsigned int y            = graph.targets[e];
+                        const Priority     new_distance = distance + graph.weights[e];
+                        // Such a path cannot be stored, but y may still have a shorter one.
+                        if(new_distance >= infinite_distance)
+                        {
+                            overflowed[y] = true;
+                            continue;
+                        }
+                        const Priority priority = new_distance << 32 | edges;
+                        if(priority < priorities[y])
+                        {
+                            priorities[y]   = priority;
+                            predecessors[y] = x;
+                            queue.push({priority, y});
+                        }
+                    }
+                }
+
+                unsigned int* distances = adjacency_matrix.data() + source * nodes;
+                unsigned int* next      = next_matrix.data() + source * nodes;
+                for(std::size_t y = 0; y < nodes; ++y)
+                {
+                    // A node that is only reached by paths that overflow has no shorter path,
+                    // as every node with a shorter distance was reached.
+                    if(priorities[y] == unreached && overflowed[y])
+                    {
+                        distance_overflow = true;
+                    }
+                    distances[y] = priorities[y] == unreached
+                                       ? infinite_distance
+                                       : static_cast<unsigned int>(priorities[y] >> 32);
+                    next[y] = predecessors[y];
+                }
+            }
+        });
+
+    return !distance_overflow;
+}
+
+/// \brief Checks that the shortest paths in \p adjacency_matrix and \p next_matrix are
+/// consistent with the input distance matrix \p input_adjacency_matrix: for every pair of
+/// connected nodes x and y, either <tt>next(x,y) == x</tt> and the distance is the weight of the
+/// edge (x,y), or the distance is the sum of the distances from x to <tt>k = next(x,y)</tt>
+/// and from k to y. Returns the number of pairs for which that does not hold.
+inline std::size_t count_inconsistent_paths(const std::vector<unsigned int>& input_adjacency_matrix,
+                                            const std::vector<unsigned int>& adjacency_matrix,
+                                            const std::vector<unsigned int>& next_matrix,
+                                            const std::size_t                nodes)
+{
+    std::size_t errors = 0;
+    for(std::size_t x = 0; x < nodes; ++x)
+    {
+        for(std::size_t y = 0; y < nodes; ++y)
+        {
+            const unsigned int d_x_y = adjacency_matrix[x * nodes + y];
+            const std::size_t  k     = next_matrix[x * nodes + y];
+            if(d_x_y >= infinite_distance || x == y)
+            {
+                continue;
+            }
+            const unsigned long long path_distance
+                = k == x ? input_adjacency_matrix[x * nodes + y]
+                         : static_cast<unsigned long long>(adjacency_matrix[x * nodes + k])
+                               + adjacency_matrix[k * nodes + y];
+            errors += k >= nodes || path_distance != d_x_y;
+        }
+    }
+    return errors;
+}
+
+/// \brief Returns whether Dijkstra's algorithm from every node (\p dijkstra_all_pairs) is
+/// expected to be faster than the Floyd-Warshall algorithm for a graph with \p nodes nodes and
+/// \p edges edges, and stores a human readable reason in \p reason.
+///
+/// Dijkstra's algorithm with a binary heap from every node performs in the order of
+/// <tt>n (n + m) log2(n)</tt> heap operations, while Floyd-Warshall performs <tt>n^3</tt>
+/// min-plus updates, which the vectorized tiled CPU implementation executes far faster than a
+/// heap operation. \p relative_cost is the ratio between the cost of both, the default value was
+/// measured with the AVX-512 min-plus kernels on random graphs of 1024 nodes.
+inline bool prefer_sparse_engine(const unsigned int nodes,
+                                 const std::size_t  edges,
+                                 std::string&       reason,
+                                 const double       relative_cost = 16.0)
+{
+    const double n                 = nodes;
+    const double log_nodes         = std::max(1.0, std::log2(n));
+    const double dijkstra_work     = n * (n + static_cast<double>(edges)) * log_nodes;
+    const double floyd_warshall    = n * n * n;
+    const double crossover_density = std::max(0.0, n / (relative_cost * log_nodes) - 1.0)
+                                     / std::max(1.0, n - 1.0);
+    const double density
+        = nodes < 2 ? 1.0 : static_cast<double>(edges) / n / (n - 1.0);
+
+    const bool         sparse = dijkstra_work * relative_cost < floyd_warshall;
+    std::ostringstream stream;
+    stream << "the density of the graph (" << density * 100.0 << "% of the possible edges) is "
+           << (sparse ? "below" : "above") << " the estimated crossover density of "
+           << crossover_density * 100.0 << "% for " << nodes << " nodes";
+    reason = stream.str();
+    return sparse;
+}
+
+#endif // _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_SPARSE_HPP
@@ -0,0 +1,116 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_UPDATE_HPP
+#define _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_UPDATE_HPP
+
+#include "example_utils.hpp"
+#include "floyd_warshall_simd.hpp"
+#include "floyd_warshall_sparse.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/// \brief Updates the shortest paths in \p adjacency_matrix and \p next_matrix, as computed by
+/// the Floyd-Warshall algorithm or \p dijkstra_all_pairs, after the weight of the edge
+/// (a,b) = (\p edge.source, \p edge.target) decreases to \p edge.weight, or after the edge is
+/// inserted with that weight. Returns whether any distance changed.
+///
+/// Every new shortest path from x to y consists of the shortest path from x to a, the edge
+/// (a,b) and the shortest path from b to y, so a single min-plus step with
+/// <tt>d(x,a) + w</tt> and row b updates the matrices in O(n^2) time. Column a and row b do
+/// not change, so the rows can be updated in place and in parallel. A row x can only change if
+/// the path through the edge reaches b sooner, i.e. <tt>d(x,a) + w < d(x,b)</tt>, so all other
+/// rows are skipped.
+///
+/// The next node of the new paths is a, except for the paths from a, whose next node is b, and
+/// the edge (a,b) itself, whose next node is a. Hence, the paths can still be reconstructed
+/// from \p next_matrix in the same way.
+inline bool apply_edge_decrease(unsigned int*            adjacency_matrix,
+                                unsigned int*            next_matrix,
+                                const unsigned int       nodes,
+                                const GraphEdge&         edge,
+                                const MinPlusRowFunction min_plus_row,
+                                const unsigned int       num_threads = 0)
+{
+    const unsigned int a = edge.source;
+    const unsigned int b = edge.target;
+    const unsigned int w = edge.weight;
+    if(a == b || w >= adjacency_matrix[static_cast<std::size_t>(a) * nodes + b])
+    {
+        return false;
+    }
+
+    const unsigned int* row_b = adjacency_matrix + static_cast<std::size_t>(b) * nodes;
+    parallel_for(nodes,
+                 64,
+                 num_threads,
+                 [&](const std::size_t begin, const std::size_t end)
+                 {
+                     for(std::size_t x = begin; x < end; ++x)
+                     {
+                         unsigned int*      distances = adjacency_matrix + x * nodes;
+                         const unsigned int d_x_a_b   = distances[a] + w;
+                         if(d_x_a_b < distances[b])
+                         {
+                             min_plus_row(distances,
+                                          next_matrix + x * nodes,
+                                          row_b,
+                                          d_x_a_b,
+                                          x == a ? b : a,
+                                          nodes);
+                         }
+                     }
+                 });
+    next_matrix[static_cast<std::size_t>(a) * nodes + b] = a;
+    return true;
+}
+
+/// \brief Applies a batch of edge weight decreases and edge insertions with
+/// \p apply_edge_decrease in O(k n^2) time for k edges, instead of recomputing all shortest
+/// paths in O(n^3) time. Edges that do not shorten their current shortest path are skipped.
+/// Returns the number of edges that changed some distance.
+inline std::size_t apply_edge_decreases(unsigned int*                 adjacency_matrix,
+                                        unsigned int*                 next_matrix,
+                                        const unsigned int            nodes,
+                                        const std::vector<GraphEdge>& edges,
+                                        const unsigned int            num_threads = 0,
+                                        const SimdLevel simd_level = get_host_simd_level())
+{
+    const MinPlusRowFunction min_plus_row
+        = get_min_plus_row_function(std::min(simd_level, get_host_simd_level()));
+
+    std::size_t changed_edges = 0;
+    for(const GraphEdge& edge : edges)
+    {
+        changed_edges += apply_edge_decrease(adjacency_matrix,
+                                             next_matrix,
+                                             nodes,
+                                             edge,
+                                             min_plus_row,
+                                             num_threads);
+    }
+    return changed_edges;
+}
+
+#endif // _APPLICATIONS_FLOYD_WARSHALL_FLOYD_WARSHALL_UPDATE_HPP
@@ -0,0 +1,169 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "cmdparser.hpp"
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/// \brief Benchmarks \p multiply_matrices against \p multiply_matrices_reference for a
+/// square product of size \p n and returns the number of elements of C that differ by more
+/// than the expected rounding error.
+template<typename T>
+int benchmark_size(const int n, const unsigned int num_threads, const std::string& type_name)
+{
+    const int lda = n;
+    const int ldb = n;
+    const int ldc = n;
+
+    // Use the same operand layouts as the solver examples: A is read row by row (strided) and
+    // B column by column.
+    std::vector<T> A(n * lda);
+    std::vector<T> B(n * ldb);
+    std::vector<T> C(n * ldc);
+    std::vector<T> C_reference(n * ldc);
+
+    std::default_random_engine        generator(n);
+    std::uniform_real_distribution<T> distribution(-1, 1);
+    std::generate(A.begin(), A.end(), [&] { return distribution(generator); });
+    std::generate(B.begin(), B.end(), [&] { return distribution(generator); });
+    std::generate(C.begin(), C.end(), [&] { return distribution(generator); });
+    const std::vector<T> C_input(C);
+
+    const T alpha = T(1.5);
+    const T beta  = T(0.5);
+
+    // The reference loop is slow for large sizes, so it is measured with fewer trials.
+    BenchmarkSettings reference_settings;
+    reference_settings.warmup_trials = 1;
+    reference_settings.min_trials    = 3;
+    reference_settings.max_time      = 2.0;
+
+    const BenchmarkResult reference_result = run_host_benchmark(
+        [&]
+        {
+            C_reference = C_input;
+            multiply_matrices_reference<T>(alpha,
+                                           beta,
+                                           n,
+                                           n,
+                                           n,
+                                           A.data(),
+                                           1,
+                                           lda,
+                                           B.data(),
+                                           1,
+                                           ldb,
+                                           C_reference.data(),
+                                           ldc);
+        },
+        reference_settings);
+
+    const BenchmarkResult blocked_result = run_host_benchmark(
+        [&]
+        {
+            C = C_input;
+            multiply_matrices<T>(alpha,
+                                 beta,
+                                 n,
+                                 n,
+                                 n,
+                                 A.data(),
+                                 1,
+                                 lda,
+                                 B.data(),
+                                 1,
+                                 ldb,
+                                 C.data(),
+                                 ldc,
+                                 num_threads);
+        });
+
+    // Both measurements include restoring C, which is negligible compared to the product.
+    const double flop = 2.0 * n * n * n;
+    std::cout << type_name << " n = " << n << ":" << std::endl;
+    print_benchmark_result("    reference", reference_result);
+    print_benchmark_result("    blocked  ", blocked_result);
+    std::cout << "    reference " << flop / reference_result.median / 1e6 << " GFLOP/s, blocked "
+              << flop / blocked_result.median / 1e6 << " GFLOP/s, speedup "
+              << reference_result.median / blocked_result.median << "x" << std::endl;
+
+    // The summation order differs between both implementations, so allow for rounding errors
+    // that grow with the length of the dot products.
+    const T tolerance = std::numeric_limits<T>::epsilon() * 8 * n;
+    int     errors    = 0;
+    for(int i = 0; i < n * ldc; ++i)
+    {
+        errors += std::abs(C[i] - C_reference[i]) > tolerance * (1 + std::abs(C_reference[i]));
+    }
+    return errors;
+}
+
+int main(int argc, char* argv[])
+{
+    // Parse user input.
+    cli::Parser parser(argc, argv);
+    parser.set_optional<int>("n",
+                             "size",
+                             512,
+                             "Largest size of the square matrices. Sizes are doubled from 64.");
+    parser.set_optional<unsigned int>("t",
+                                      "threads",
+                                      0,
+                                      "Number of host threads (0 uses all available threads).");
+    parser.run_and_exit_if_error();
+
+    const int          max_size    = parser.get<int>("n");
+    const unsigned int num_threads = parser.get<unsigned int>("t");
+    if(max_size < 1)
+    {
+        std::cout << "Size must be at least 1." << std::endl;
+        return error_exit_code;
+    }
+
+    std::cout << "Comparing multiply_matrices with the reference triple loop using "
+              << (num_threads ? num_threads : get_default_host_threads()) << " host threads."
+              << std::endl;
+
+    // Double the size from 64 up to the requested size.
+    std::vector<int> sizes;
+    for(int n = 64; n < max_size; n *= 2)
+    {
+        sizes.push_back(n);
+    }
+    sizes.push_back(max_size);
+
+    int errors = 0;
+    for(const int n : sizes)
+    {
+        errors += benchmark_size<float>(n, num_threads, "float");
+        errors += benchmark_size<double>(n, num_threads, "double");
+    }
+
+    return report_validation_result(errors);
+}
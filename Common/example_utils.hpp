@@ -23,16 +23,30 @@
 #ifndef COMMON_EXAMPLE_UTILS_HPP
 #define COMMON_EXAMPLE_UTILS_HPP
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 #include <hip/hip_runtime.h>
 
+#if defined(_MSC_VER) && (defined(__x86_64__) || defined(_M_X64))
+    #include <intrin.h>
+#endif
+#if defined(__linux__)
+    #include <unistd.h>
+#endif
+
 constexpr int error_exit_code = -1;
 
 /// \brief Checks if the provided error code is \p hipSuccess and if not,
@@ -160,6 +174,371 @@ public:
     }
 };
 
+/// \brief Settings that control how \p run_benchmark measures a piece of work.
+struct BenchmarkSettings
+{
+    /// Number of untimed executions performed before the first measurement.
+    unsigned int warmup_trials = 3;
+
+    /// Minimum number of timed executions.
+    unsigned int min_trials = 10;
+
+    /// Maximum number of timed executions.
+    unsigned int max_trials = 1000;
+
+    /// Measuring stops as soon as the half-width of the 95% confidence interval of the mean
+    /// drops below this fraction of the mean.
+    double target_relative_error = 0.02;
+
+    /// Samples whose modified z-score (distance from the median in units of the scaled
+    /// median absolute deviation) exceeds this value are rejected as outliers.
+    double outlier_threshold = 3.5;
+
+    /// Upper bound in seconds for the total time spent in timed executions once
+    /// \p min_trials samples have been collected.
+    double max_time = 5.0;
+};
+
+/// \brief Statistics of a benchmark run. All times are in milliseconds.
+struct BenchmarkResult
+{
+    /// Number of timed executions.
+    unsigned int trials = 0;
+
+    /// Number of samples rejected as outliers. They are excluded from the mean, standard
+    /// deviation and confidence interval, but not from the order statistics.
+    unsigned int outliers = 0;
+
+    double mean                = 0;
+    double stddev              = 0;
+    double confidence_interval = 0;
+    double min                 = 0;
+    double median              = 0;
+    double p90                 = 0;
+    double p99                 = 0;
+};
+
+/// \brief Returns the two-sided 95% quantile of the Student's t-distribution with
+/// \p degrees_of_freedom degrees of freedom.
+inline double student_t_95(const std::size_t degrees_of_freedom)
+{
+    constexpr double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+                                2.228,  2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101,
+                                2.093,  2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052,
+                                2.048,  2.045, 2.042};
+    constexpr std::size_t table_size = sizeof(table) / sizeof(table[0]);
+    if(degrees_of_freedom == 0)
+    {
+        return table[0];
+    }
+    return degrees_of_freedom <= table_size ? table[degrees_of_freedom - 1] : 1.960;
+}
+
+/// \brief Returns the \p fraction quantile of the sorted range \p sorted using linear
+/// interpolation between the closest ranks.
+inline double sorted_quantile(const std::vector<double>& sorted, const double fraction)
+{
+    assert(!sorted.empty());
+    const double      position = fraction * (sorted.size() - 1);
+    const std::size_t lower    = static_cast<std::size_t>(position);
+    const std::size_t upper    = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (position - lower) * (sorted[upper] - sorted[lower]);
+}
+
+/// \brief Computes the statistics of a set of time samples (in milliseconds), rejecting
+/// outliers by their modified z-score.
+inline BenchmarkResult compute_benchmark_statistics(const std::vector<double>& samples,
+                                                    const double outlier_threshold)
+{
+    BenchmarkResult result;
+    result.trials = static_cast<unsigned int>(samples.size());
+    if(samples.empty())
+    {
+        return result;
+    }
+
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    result.min    = sorted.front();
+    result.median = sorted_quantile(sorted, 0.5);
+    result.p90    = sorted_quantile(sorted, 0.9);
+    result.p99    = sorted_quantile(sorted, 0.99);
+
+    // Median absolute deviation, scaled to be a consistent estimator of the standard deviation.
+    std::vector<double> deviations(sorted.size());
+    std::transform(sorted.begin(),
+                   sorted.end(),
+                   deviations.begin(),
+                   [&](const double sample) { return std::abs(sample - result.median); });
+    std::sort(deviations.begin(), deviations.end());
+    const double mad = 1.4826 * sorted_quantile(deviations, 0.5);
+
+    // The median absolute deviation of a handful of samples is not a meaningful estimate.
+    constexpr std::size_t min_samples_for_rejection = 5;
+    const bool            reject_outliers
+        = mad > 0 && sorted.size() >= min_samples_for_rejection;
+
+    double       sum     = 0;
+    double       sum_sq  = 0;
+    unsigned int inliers = 0;
+    for(const double sample : sorted)
+    {
+        if(reject_outliers && std::abs(sample - result.median) / mad > outlier_threshold)
+        {
+            continue;
+        }
+        sum += sample;
+        sum_sq += sample * sample;
+        ++inliers;
+    }
+    result.outliers = result.trials - inliers;
+    result.mean     = sum / inliers;
+    if(inliers > 1)
+    {
+        const double variance = std::max(0.0, (sum_sq - sum * result.mean) / (inliers - 1));
+        result.stddev         = std::sqrt(variance);
+        result.confidence_interval
+            = student_t_95(inliers - 1) * result.stddev / std::sqrt(static_cast<double>(inliers));
+    }
+    return result;
+}
+
+/// \brief Repeatedly executes \p trial until the mean execution time is known with the
+/// precision requested by \p settings.
+/// \tparam Trial - callable without arguments that executes the measured work once and returns
+/// its execution time in milliseconds. Any per-trial setup that should not be measured (e.g.
+/// restoring the input data) can be done inside \p trial outside of the timed region.
+template<typename Trial>
+BenchmarkResult run_benchmark(Trial&& trial, const BenchmarkSettings& settings = {})
+{
+    for(unsigned int i = 0; i < settings.warmup_trials; ++i)
+    {
+        trial();
+    }
+
+    const unsigned int min_trials = std::max(settings.min_trials, 1u);
+    const unsigned int max_trials = std::max(settings.max_trials, min_trials);
+
+    std::vector<double> samples;
+    samples.reserve(min_trials);
+    double          total_ms = 0;
+    BenchmarkResult result;
+    while(samples.size() < max_trials)
+    {
+        const double sample = trial();
+        samples.push_back(sample);
+        total_ms += sample;
+        if(samples.size() < min_trials)
+        {
+            continue;
+        }
+
+        // A single sample says nothing about the spread of the execution times.
+        result = compute_benchmark_statistics(samples, settings.outlier_threshold);
+        if((samples.size() > 1
+            && result.confidence_interval <= settings.target_relative_error * result.mean)
+           || total_ms >= settings.max_time * 1000.0)
+        {
+            return result;
+        }
+    }
+    return result;
+}
+
+/// \brief Runs \p run_benchmark for work that is executed synchronously on the host, timing
+/// each call of \p work with a \p HostClock.
+template<typename Work>
+BenchmarkResult run_host_benchmark(Work&& work, const BenchmarkSettings& settings = {})
+{
+    return run_benchmark(
+        [&]
+        {
+            HostClock clock;
+            clock.start_timer();
+            work();
+            clock.stop_timer();
+            return clock.get_elapsed_time() * 1000.0;
+        },
+        settings);
+}
+
+/// \brief Prints the statistics of a benchmark run to the standard output.
+inline void print_benchmark_result(const std::string& name, const BenchmarkResult& result)
+{
+    std::cout << name << ": mean " << result.mean << " ms +/- " << result.confidence_interval
+              << " ms (95% CI, " << result.trials << " trials, " << result.outliers
+              << " outliers rejected)\n"
+              << "    min " << result.min << " ms, median " << result.median << " ms, p90 "
+              << result.p90 << " ms, p99 " << result.p99 << " ms, stddev " << result.stddev
+              << " ms" << std::endl;
+}
+
+/// \brief Returns the number of host threads used by \p parallel_for when none is specified.
+inline unsigned int get_default_host_threads()
+{
+    const unsigned int threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+
+/// \brief Splits the range <tt>[0, size)</tt> into at most \p num_threads contiguous chunks and
+/// calls <tt>function(begin, end)</tt> for each of them on its own host thread. The length of
+/// every chunk but the last is a multiple of \p grain. The calling thread processes the first
+/// chunk. If \p num_threads is 0, \p get_default_host_threads() threads are used.
+template<typename Function>
+void parallel_for(const std::size_t size,
+                  const std::size_t grain,
+                  unsigned int      num_threads,
+                  Function&&        function)
+{
+    if(num_threads == 0)
+    {
+        num_threads = get_default_host_threads();
+    }
+    const std::size_t grains = (size + grain - 1) / grain;
+    const std::size_t chunks = std::min<std::size_t>(num_threads, grains);
+    if(chunks <= 1)
+    {
+        if(size > 0)
+        {
+            function(std::size_t{0}, size);
+        }
+        return;
+    }
+
+    const std::size_t        chunk_size = (grains + chunks - 1) / chunks * grain;
+    std::vector<std::thread> threads;
+    threads.reserve(chunks - 1);
+    for(std::size_t begin = chunk_size; begin < size; begin += chunk_size)
+    {
+        const std::size_t end = std::min(begin + chunk_size, size);
+        threads.emplace_back([&function, begin, end] { function(begin, end); });
+    }
+    function(std::size_t{0}, std::min(chunk_size, size));
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+/// \brief Reusable synchronization point for a fixed number of host threads.
+class HostBarrier
+{
+public:
+    explicit HostBarrier(const unsigned int count) : count(count) {}
+
+    /// \brief Blocks until all \p count threads have called this function, then releases them.
+    void arrive_and_wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const unsigned long long     current = generation;
+        if(++arrived == count)
+        {
+            arrived = 0;
+            ++generation;
+            lock.unlock();
+            released.notify_all();
+            return;
+        }
+        released.wait(lock, [&] { return generation != current; });
+    }
+
+private:
+    std::mutex              mutex;
+    std::condition_variable released;
+    unsigned int            count;
+    unsigned int            arrived    = 0;
+    unsigned long long      generation = 0;
+};
+
+/// \brief Vector instruction set extensions that the CPU implementations of the examples can be
+/// specialized for, in increasing order of capability.
+enum class SimdLevel
+{
+    scalar,
+    avx2,
+    avx512
+};
+
+/// \brief Returns the name of a \p SimdLevel, as accepted by \p parse_simd_level.
+inline const char* simd_level_name(const SimdLevel level)
+{
+    switch(level)
+    {
+        case SimdLevel::avx2: return "avx2";
+        case SimdLevel::avx512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+/// \brief Parses the name of a \p SimdLevel into \p level. Returns false if \p name is unknown.
+inline bool parse_simd_level(const std::string& name, SimdLevel& level)
+{
+    for(const SimdLevel candidate : {SimdLevel::scalar, SimdLevel::avx2, SimdLevel::avx512})
+    {
+        if(name == simd_level_name(candidate))
+        {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// \brief Returns the most capable \p SimdLevel that both the host CPU and the operating system
+/// support. AVX-512 refers to the foundation instructions (AVX-512F).
+inline SimdLevel get_host_simd_level()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    #if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    // The CPU supports AVX and the operating system saves the AVX registers.
+    const bool has_os_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0
+                            && (_xgetbv(0) & 0x6) == 0x6;
+    if(!has_os_avx || max_leaf < 7)
+    {
+        return SimdLevel::scalar;
+    }
+    __cpuidex(info, 7, 0);
+    if((info[1] & (1 << 16)) != 0 && (_xgetbv(0) & 0xE6) == 0xE6)
+    {
+        return SimdLevel::avx512;
+    }
+    if((info[1] & (1 << 5)) != 0)
+    {
+        return SimdLevel::avx2;
+    }
+    #else
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f"))
+    {
+        return SimdLevel::avx512;
+    }
+    if(__builtin_cpu_supports("avx2"))
+    {
+        return SimdLevel::avx2;
+    }
+    #endif
+#endif
+    return SimdLevel::scalar;
+}
+
+/// \brief Returns the size in bytes of the level 2 data cache of a core of the host CPU, or
+/// \p fallback if the operating system does not report it.
+inline std::size_t get_host_l2_cache_size(const std::size_t fallback = 256 * 1024)
+{
+#if defined(__linux__) && defined(_SC_LEVEL2_CACHE_SIZE)
+    const long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if(size > 0)
+    {
+        return static_cast<std::size_t>(size);
+    }
+#endif
+    return fallback;
+}
+
 /// \brief Returns <tt>ceil(dividend / divisor)</tt>, where \p dividend is an integer and
 /// \p divisor is an unsigned integer.
 template<typename T,
@@ -197,22 +576,23 @@ void generate_identity_matrix(T* A, int m, int n, size_t lda)
     }
 }
 
-/// \brief Multiply an $A$ matrix ($m \times k$) with a $B$ matrix ($k \times n$) as:
+/// \brief Reference implementation of \p multiply_matrices with a plain triple loop.
+/// Multiplies an $A$ matrix ($m \times k$) with a $B$ matrix ($k \times n$) as:
 /// $C := \alpha \cdot A \cdot B + \beta \cdot C$
 template<typename T>
-void multiply_matrices(T        alpha,
-                       T        beta,
-                       int      m,
-                       int      n,
-                       int      k,
-                       const T* A,
-                       int      stride1_a,
-                       int      stride2_a,
-                       const T* B,
-                       int      stride1_b,
-                       int      stride2_b,
-                       T*       C,
-                       int      stride_c)
+void multiply_matrices_reference(T        alpha,
+                                 T        beta,
+                                 int      m,
+                                 int      n,
+                                 int      k,
+                                 const T* A,
+                                 int      stride1_a,
+                                 int      stride2_a,
+                                 const T* B,
+                                 int      stride1_b,
+                                 int      stride2_b,
+                                 T*       C,
+                                 int      stride_c)
 {
     for(int i1 = 0; i1 < m; ++i1)
     {
@@ -228,4 +608,327 @@ void multiply_matrices(T        alpha,
     }
 }
 
+/// \brief Block sizes used by \p multiply_matrices. A micro-tile of \p mr x \p nr elements of C
+/// is kept in registers, a \p kc deep sliver of B (\p kc x \p nr) is meant to stay in the L1
+/// cache, a packed \p mc x \p kc panel of A in the L2 cache and a packed \p kc x \p nc panel of B
+/// in the L3 cache. \p mr spans two 128-bit vector registers so that the compiler can vectorize
+/// the micro-kernel along the columns of C, while the \p mr x \p nr accumulators still fit in
+/// the vector register file of the baseline x86-64 and AArch64 instruction sets.
+template<typename T>
+struct GemmBlocking
+{
+    static constexpr int mr = sizeof(T) <= 16 ? static_cast<int>(32 / sizeof(T)) : 1;
+    static constexpr int nr = 6;
+    static constexpr int kc = 256;
+    static constexpr int mc = 16 * mr;
+    static constexpr int nc = 512 * nr;
+};
+
+/// \brief Packs the \p rows x \p depth block of A at \p A into \p packed as consecutive slivers
+/// of \p Mr rows, each stored column by column. Rows beyond \p rows are padded with zeros, so the
+/// micro-kernel never has to deal with partial slivers.
+template<int Mr, typename T>
+void gemm_pack_a(const int rows,
+                 const int depth,
+                 const T*  A,
+                 const int stride1_a,
+                 const int stride2_a,
+                 T*        packed)
+{
+    for(int row = 0; row < rows; row += Mr)
+    {
+        const int sliver_rows = std::min(Mr, rows - row);
+        for(int p = 0; p < depth; ++p)
+        {
+            const T* column = A + row * stride1_a + p * stride2_a;
+            for(int i = 0; i < sliver_rows; ++i)
+            {
+                packed[i] = column[i * stride1_a];
+            }
+            for(int i = sliver_rows; i < Mr; ++i)
+            {
+                packed[i] = T(0);
+            }
+            packed += Mr;
+        }
+    }
+}
+
+/// \brief Packs the \p depth x \p cols block of B at \p B into \p packed as consecutive slivers
+/// of \p Nr columns, each stored row by row and padded with zeros.
+template<int Nr, typename T>
+void gemm_pack_b(const int depth,
+                 const int cols,
+                 const T*  B,
+                 const int stride1_b,
+                 const int stride2_b,
+                 T*        packed)
+{
+    for(int col = 0; col < cols; col += Nr)
+    {
+        const int sliver_cols = std::min(Nr, cols - col);
+        for(int p = 0; p < depth; ++p)
+        {
+            const T* row = B + p * stride1_b + col * stride2_b;
+            for(int j = 0; j < sliver_cols; ++j)
+            {
+                packed[j] = row[j * stride2_b];
+            }
+            for(int j = sliver_cols; j < Nr; ++j)
+            {
+                packed[j] = T(0);
+            }
+            packed += Nr;
+        }
+    }
+}
+
+/// \brief Computes the \p Mr x \p Nr product of a packed sliver of A and a packed sliver of B
+/// and accumulates <tt>alpha</tt> times the result into the \p rows x \p cols tile of C at
+/// \p C. The accumulators are kept in a fixed-size local array. The kernel is plain C++ without
+/// vector intrinsics: it is only vectorized if the compiler auto-vectorizes its loops, which
+/// GCC and Clang do with optimizations enabled, and otherwise runs as scalar code.
+template<int Mr, int Nr, typename T>
+void gemm_micro_kernel(const int depth,
+                       const T   alpha,
+                       const T*  packed_a,
+                       const T*  packed_b,
+                       T*        C,
+                       const int stride_c,
+                       const int rows,
+                       const int cols)
+{
+    T accumulators[Nr * Mr] = {};
+    for(int p = 0; p < depth; ++p)
+    {
+        // Load the column of the A sliver once, so it can be kept in registers while it is
+        // multiplied with every element of the row of the B sliver.
+        T a[Mr];
+        for(int i = 0; i < Mr; ++i)
+        {
+            a[i] = packed_a[p * Mr + i];
+        }
+        for(int j = 0; j < Nr; ++j)
+        {
+            for(int i = 0; i < Mr; ++i)
+            {
+                accumulators[j * Mr + i] += a[i] * packed_b[p * Nr + j];
+            }
+        }
+    }
+
+    for(int j = 0; j < cols; ++j)
+    {
+        T* column = C + j * stride_c;
+        for(int i = 0; i < rows; ++i)
+        {
+            column[i] += alpha * accumulators[j * Mr + i];
+        }
+    }
+}
+
+/// \brief Returns the first element of the part of <tt>[0, size)</tt> that is assigned to thread
+/// \p thread out of \p num_threads, when the range is split into parts of nearly equal length.
+inline int get_thread_range_begin(const int          size,
+                                  const unsigned int thread,
+                                  const unsigned int num_threads)
+{
+    return static_cast<int>(static_cast<long long>(size) * thread / num_threads);
+}
+
+/// \brief Multithreaded blocked implementation of \p multiply_matrices. Loops over panels of A
+/// and B that are packed once per panel into contiguous buffers shared by all \p num_threads
+/// threads, and splits the micro-tiles of C that the panels contribute to between the threads.
+/// The threads split the rows of C if there are enough of them, and the columns otherwise.
+template<typename T>
+void multiply_matrices_blocked(T            alpha,
+                               T            beta,
+                               int          m,
+                               int          n,
+                               int          k,
+                               const T*     A,
+                               int          stride1_a,
+                               int          stride2_a,
+                               const T*     B,
+                               int          stride1_b,
+                               int          stride2_b,
+                               T*           C,
+                               int          stride_c,
+                               unsigned int num_threads)
+{
+    using Blocking   = GemmBlocking<T>;
+    constexpr int mr = Blocking::mr;
+    constexpr int nr = Blocking::nr;
+
+    const int      max_depth   = std::min(Blocking::kc, k);
+    const int      max_cols    = std::min(Blocking::nc, n);
+    const int      row_slivers = (m + mr - 1) / mr;
+    std::vector<T> packed_a(static_cast<std::size_t>(row_slivers) * mr * max_depth);
+    std::vector<T> packed_b(static_cast<std::size_t>((max_cols + nr - 1) / nr) * nr * max_depth);
+
+    const bool  split_rows = row_slivers >= static_cast<int>(num_threads);
+    HostBarrier barrier(num_threads);
+
+    const auto worker = [&](const unsigned int thread)
+    {
+        const auto range_begin = [&](const int size, const unsigned int part)
+        { return get_thread_range_begin(size, part, num_threads); };
+
+        // Apply beta once, so that all blocks in the k dimension can simply accumulate into C.
+        for(int col = range_begin(n, thread); col < range_begin(n, thread + 1); ++col)
+        {
+            for(int row = 0; row < m; ++row)
+            {
+                C[row + col * stride_c] = beta * C[row + col * stride_c];
+            }
+        }
+
+        for(int jc = 0; jc < n; jc += Blocking::nc)
+        {
+            const int cols        = std::min(Blocking::nc, n - jc);
+            const int col_slivers = (cols + nr - 1) / nr;
+            for(int pc = 0; pc < k; pc += Blocking::kc)
+            {
+                const int depth = std::min(Blocking::kc, k - pc);
+
+                // Every thread packs its share of the slivers of both panels.
+                const int first_b = range_begin(col_slivers, thread) * nr;
+                const int last_b  = std::min(range_begin(col_slivers, thread + 1) * nr, cols);
+                if(first_b < last_b)
+                {
+                    gemm_pack_b<nr>(depth,
+                                    last_b - first_b,
+                                    B + pc * stride1_b + (jc + first_b) * stride2_b,
+                                    stride1_b,
+                                    stride2_b,
+                                    packed_b.data() + first_b * depth);
+                }
+                const int first_a = range_begin(row_slivers, thread) * mr;
+                const int last_a  = std::min(range_begin(row_slivers, thread + 1) * mr, m);
+                if(first_a < last_a)
+                {
+                    gemm_pack_a<mr>(last_a - first_a,
+                                    depth,
+                                    A + first_a * stride1_a + pc * stride2_a,
+                                    stride1_a,
+                                    stride2_a,
+                                    packed_a.data() + first_a * depth);
+                }
+                barrier.arrive_and_wait();
+
+                const int row_begin = split_rows ? first_a : 0;
+                const int row_end   = split_rows ? last_a : m;
+                const int col_begin = split_rows ? 0 : first_b;
+                const int col_end   = split_rows ? cols : last_b;
+                for(int ic = row_begin; ic < row_end; ic += Blocking::mc)
+                {
+                    const int rows = std::min(Blocking::mc, row_end - ic);
+                    for(int jr = col_begin; jr < col_end; jr += nr)
+                    {
+                        for(int ir = ic; ir < ic + rows; ir += mr)
+                        {
+                            gemm_micro_kernel<mr, nr>(depth,
+                                                      alpha,
+                                                      packed_a.data() + ir * depth,
+                                                      packed_b.data() + jr * depth,
+                                                      C + ir + (jc + jr) * stride_c,
+                                                      stride_c,
+                                                      std::min(mr, m - ir),
+                                                      std::min(nr, cols - jr));
+                        }
+                    }
+                }
+
+                // The panels are overwritten by the next iteration.
+                barrier.arrive_and_wait();
+            }
+        }
+    };
+
+    parallel_for(num_threads,
+                 1,
+                 num_threads,
+                 [&](const std::size_t begin, const std::size_t end)
+                 {
+                     for(std::size_t thread = begin; thread < end; ++thread)
+                     {
+                         worker(static_cast<unsigned int>(thread));
+                     }
+                 });
+}
+
+/// \brief Multiply an $A$ matrix ($m \times k$) with a $B$ matrix ($k \times n$) as:
+/// $C := \alpha \cdot A \cdot B + \beta \cdot C$
+/// Element $(i, j)$ of $A$ is read from <tt>A[i * stride1_a + j * stride2_a]</tt>, and
+/// analogously for $B$, while $C$ is stored in column-major order with leading dimension
+/// \p stride_c. The product is computed with a cache-blocked, packed algorithm by
+/// \p num_threads host threads (by default, \p get_default_host_threads()). Products that are
+/// too small to benefit from blocking are computed by \p multiply_matrices_reference.
+template<typename T>
+void multiply_matrices(T            alpha,
+                       T            beta,
+                       int          m,
+                       int          n,
+                       int          k,
+                       const T*     A,
+                       int          stride1_a,
+                       int          stride2_a,
+                       const T*     B,
+                       int          stride1_b,
+                       int          stride2_b,
+                       T*           C,
+                       int          stride_c,
+                       unsigned int num_threads = 0)
+{
+    // Below this number of multiply-adds, packing costs more than it saves.
+    constexpr double blocking_threshold = 32.0 * 32.0 * 32.0;
+    // Minimum number of multiply-adds assigned to each host thread.
+    constexpr double thread_work = 64.0 * 64.0 * 64.0;
+
+    if(m <= 0 || n <= 0)
+    {
+        return;
+    }
+    const double work = static_cast<double>(m) * n * k;
+    if(work < blocking_threshold)
+    {
+        multiply_matrices_reference(alpha,
+                                    beta,
+                                    m,
+                                    n,
+                                    k,
+                                    A,
+                                    stride1_a,
+                                    stride2_a,
+                                    B,
+                                    stride1_b,
+                                    stride2_b,
+                                    C,
+                                    stride_c);
+        return;
+    }
+
+    if(num_threads == 0)
+    {
+        num_threads = get_default_host_threads();
+    }
+    num_threads = static_cast<unsigned int>(
+        std::max(1.0, std::min<double>(num_threads, std::floor(work / thread_work))));
+
+    multiply_matrices_blocked(alpha,
+                              beta,
+                              m,
+                              n,
+                              k,
+                              A,
+                              stride1_a,
+                              stride2_a,
+                              B,
+                              stride1_b,
+                              stride2_b,
+                              C,
+                              stride_c,
+                              num_threads);
+}
+
 #endif // COMMON_EXAMPLE_UTILS_HPP
@@ -0,0 +1,373 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef COMMON_TASK_GRAPH_HPP
+#define COMMON_TASK_GRAPH_HPP
+
+#include "example_utils.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <hip/hip_runtime.h>
+
+/// \brief Directed acyclic graph of tasks that is built once and executed many times.
+///
+/// Every task has a device version, which enqueues asynchronous work such as kernel launches
+/// or copies to the stream that it receives, and a host version, which performs the same work
+/// on the host for the items <tt>[begin, end)</tt> of a range of \p host_size independent
+/// items, so that the host executor can split it among threads. Either version may be empty
+/// for tasks that only exist on one side, or for tasks that only join their dependencies.
+class TaskGraph
+{
+public:
+    using TaskId     = std::size_t;
+    using DeviceTask = std::function<void(hipStream_t)>;
+    using HostTask   = std::function<void(std::size_t begin, std::size_t end)>;
+
+    /// \brief Adds a task that can start once all tasks in \p dependencies have finished, and
+    /// returns its identifier. Tasks can only depend on previously added tasks.
+    TaskId add_task(DeviceTask                 device_task,
+                    HostTask                   host_task,
+                    const std::size_t          host_size,
+                    const std::vector<TaskId>& dependencies)
+    {
+        tasks.push_back({std::move(device_task), std::move(host_task), host_size, dependencies});
+        return tasks.size() - 1;
+    }
+
+    /// \brief Adds a task that depends on the previously added task, if any. Sequences of such
+    /// tasks replace a series of launches on a single stream.
+    TaskId add_task(DeviceTask        device_task,
+                    HostTask          host_task = {},
+                    const std::size_t host_size = 1)
+    {
+        std::vector<TaskId> dependencies;
+        if(!tasks.empty())
+        {
+            dependencies.push_back(tasks.size() - 1);
+        }
+        return add_task(std::move(device_task), std::move(host_task), host_size, dependencies);
+    }
+
+    std::size_t size() const
+    {
+        return tasks.size();
+    }
+
+    const DeviceTask& get_device_task(const TaskId task) const
+    {
+        return tasks[task].device_task;
+    }
+
+    const HostTask& get_host_task(const TaskId task) const
+    {
+        return tasks[task].host_task;
+    }
+
+    std::size_t get_host_size(const TaskId task) const
+    {
+        return tasks[task].host_size;
+    }
+
+    const std::vector<TaskId>& get_dependencies(const TaskId task) const
+    {
+        return tasks[task].dependencies;
+    }
+
+private:
+    struct Task
+    {
+        DeviceTask          device_task;
+        HostTask            host_task;
+        std::size_t         host_size;
+        std::vector<TaskId> dependencies;
+    };
+
+    std::vector<Task> tasks;
+};
+
+/// \brief Ways in which the examples can execute a sequence of kernels.
+enum class LaunchMode
+{
+    /// Launch every kernel separately on a stream.
+    stream,
+    /// Capture the kernels in a \p TaskGraph once and launch it as a single HIP graph.
+    graph,
+    /// Execute the host versions of the tasks of the \p TaskGraph on a pool of host threads.
+    host
+};
+
+/// \brief Returns the name of a \p LaunchMode, as accepted by \p parse_launch_mode.
+inline const char* launch_mode_name(const LaunchMode mode)
+{
+    switch(mode)
+    {
+        case LaunchMode::graph: return "graph";
+        case LaunchMode::host: return "host";
+        default: return "stream";
+    }
+}
+
+/// \brief Parses the name of a \p LaunchMode. Returns false if \p name is not valid.
+inline bool parse_launch_mode(const std::string& name, LaunchMode& mode)
+{
+    for(const LaunchMode candidate : {LaunchMode::stream, LaunchMode::graph, LaunchMode::host})
+    {
+        if(name == launch_mode_name(candidate))
+        {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// \brief Executes the device tasks of a \p TaskGraph as a single HIP graph. Each task is
+/// captured from a stream into a child graph once, when the executor is created, and the
+/// dependencies between tasks become the edges between those child graphs. Launching the
+/// executor then enqueues all tasks with a single call.
+class HipGraphExecutor
+{
+public:
+    explicit HipGraphExecutor(const TaskGraph& task_graph)
+    {
+        hipStream_t capture_stream;
+        HIP_CHECK(hipStreamCreateWithFlags(&capture_stream, hipStreamNonBlocking));
+        HIP_CHECK(hipGraphCreate(&graph, 0));
+
+        std::vector<hipGraphNode_t> nodes(task_graph.size());
+        std::vector<hipGraphNode_t> dependencies;
+        for(TaskGraph::TaskId task = 0; task < task_graph.size(); ++task)
+        {
+            dependencies.clear();
+            for(const TaskGraph::TaskId dependency : task_graph.get_dependencies(task))
+            {
+                dependencies.push_back(nodes[dependency]);
+            }
+
+            const TaskGraph::DeviceTask& device_task = task_graph.get_device_task(task);
+            if(!device_task)
+            {
+                HIP_CHECK(hipGraphAddEmptyNode(&nodes[task],
+                                               graph,
+                                               dependencies.data(),
+                                               dependencies.size()));
+                continue;
+            }
+
+            hipGraph_t child_graph;
+            HIP_CHECK(hipStreamBeginCapture(capture_stream, hipStreamCaptureModeThreadLocal));
+            device_task(capture_stream);
+            HIP_CHECK(hipStreamEndCapture(capture_stream, &child_graph));
+            HIP_CHECK(hipGraphAddChildGraphNode(&nodes[task],
+                                                graph,
+                                                dependencies.data(),
+                                                dependencies.size(),
+                                                child_graph));
+            HIP_CHECK(hipGraphDestroy(child_graph));
+        }
+
+        HIP_CHECK(hipGraphInstantiate(&graph_exec, graph, nullptr, nullptr, 0));
+        HIP_CHECK(hipStreamDestroy(capture_stream));
+    }
+
+    HipGraphExecutor(const HipGraphExecutor&)            = delete;
+    HipGraphExecutor& operator=(const HipGraphExecutor&) = delete;
+
+    ~HipGraphExecutor()
+    {
+        HIP_CHECK(hipGraphExecDestroy(graph_exec));
+        HIP_CHECK(hipGraphDestroy(graph));
+    }
+
+    /// \brief Enqueues all tasks of the graph to \p stream.
+    void launch(const hipStream_t stream) const
+    {
+        HIP_CHECK(hipGraphLaunch(graph_exec, stream));
+    }
+
+private:
+    hipGraph_t     graph;
+    hipGraphExec_t graph_exec;
+};
+
+/// \brief Executes the host tasks of a \p TaskGraph on a pool of host threads that is created
+/// once, together with the executor. The range of every task is split into one part per thread,
+/// and a task is started as soon as all parts of its dependencies have finished, so that
+/// independent tasks can overlap and no threads are created or joined between tasks.
+class HostGraphExecutor
+{
+public:
+    /// \brief Creates the pool of \p num_threads threads (by default,
+    /// \p get_default_host_threads()) for \p task_graph, which must outlive the executor.
+    explicit HostGraphExecutor(const TaskGraph& task_graph, unsigned int num_threads = 0)
+        : task_graph(task_graph)
+        , successors(task_graph.size())
+        , pending_dependencies(task_graph.size())
+        , pending_parts(task_graph.size())
+    {
+        for(TaskGraph::TaskId task = 0; task < task_graph.size(); ++task)
+        {
+            for(const TaskGraph::TaskId dependency : task_graph.get_dependencies(task))
+            {
+                successors[dependency].push_back(task);
+            }
+        }
+
+        if(num_threads == 0)
+        {
+            num_threads = get_default_host_threads();
+        }
+        parts_per_task = num_threads;
+        for(unsigned int i = 0; i < num_threads; ++i)
+        {
+            threads.emplace_back([this] { work(); });
+        }
+    }
+
+    HostGraphExecutor(const HostGraphExecutor&)            = delete;
+    HostGraphExecutor& operator=(const HostGraphExecutor&) = delete;
+
+    ~HostGraphExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        work_available.notify_all();
+        for(std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    /// \brief Executes all tasks of the graph and waits until they have finished.
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished_tasks = 0;
+        for(TaskGraph::TaskId task = 0; task < task_graph.size(); ++task)
+        {
+            pending_dependencies[task] = task_graph.get_dependencies(task).size();
+            if(pending_dependencies[task] == 0)
+            {
+                make_ready(task);
+            }
+        }
+        work_available.notify_all();
+        work_finished.wait(lock, [&] { return finished_tasks == task_graph.size(); });
+    }
+
+private:
+    /// \brief Part of the range of a task.
+    struct WorkItem
+    {
+        TaskGraph::TaskId task;
+        std::size_t       begin;
+        std::size_t       end;
+    };
+
+    /// \brief Queues the parts of \p task. Must be called with the mutex held.
+    void make_ready(const TaskGraph::TaskId task)
+    {
+        const std::size_t size
+            = task_graph.get_host_task(task) ? task_graph.get_host_size(task) : 0;
+        const std::size_t parts
+            = std::max<std::size_t>(1, std::min<std::size_t>(parts_per_task, size));
+        pending_parts[task] = parts;
+        for(std::size_t part = 0; part < parts; ++part)
+        {
+            ready.push_back({task, size * part / parts, size * (part + 1) / parts});
+        }
+    }
+
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while(true)
+        {
+            work_available.wait(lock, [&] { return stopping || !ready.empty(); });
+            if(ready.empty())
+            {
+                return;
+            }
+            const WorkItem item = ready.back();
+            ready.pop_back();
+
+            lock.unlock();
+            if(item.begin < item.end)
+            {
+                task_graph.get_host_task(item.task)(item.begin, item.end);
+            }
+            lock.lock();
+
+            if(--pending_parts[item.task] != 0)
+            {
+                continue;
+            }
+            const std::size_t ready_before = ready.size();
+            for(const TaskGraph::TaskId successor : successors[item.task])
+            {
+                if(--pending_dependencies[successor] == 0)
+                {
+                    make_ready(successor);
+                }
+            }
+            if(ready.size() > ready_before + 1)
+            {
+                work_available.notify_all();
+            }
+            else if(ready.size() > ready_before)
+            {
+                work_available.notify_one();
+            }
+            if(++finished_tasks == task_graph.size())
+            {
+                work_finished.notify_all();
+            }
+        }
+    }
+
+    const TaskGraph&                            task_graph;
+    std::vector<std::vector<TaskGraph::TaskId>> successors;
+    std::vector<std::size_t>                    pending_dependencies;
+    std::vector<std::size_t>                    pending_parts;
+    std::size_t                                 parts_per_task = 1;
+    std::size_t                                 finished_tasks = 0;
+    bool                                        stopping       = false;
+
+    std::vector<WorkItem>    ready;
+    std::mutex               mutex;
+    std::condition_variable  work_available;
+    std::condition_variable  work_finished;
+    std::vector<std::thread> threads;
+};
+
+#endif // COMMON_TASK_GRAPH_HPP